@@ -55,6 +55,16 @@ struct const_input_iterator {
     using pointer = T**;  // or also value_type*
     using reference = T*&;  // or also value_type&
 };
+
+// operator-> of an iterator whose operator* returns a value ( say a pair of references ),
+// keeps that value alive for the rest of the expression
+template<typename T>
+struct _Arrow_Proxy {
+    T value;
+    T* operator->() noexcept {
+        return &value;
+    }
+};
 SSTD_END
 
 #endif
\ No newline at end of file
@@ -0,0 +1,205 @@
+#ifndef SSTD_CONCURRENT_UNORDERED_MAP_INCLUDED
+#define SSTD_CONCURRENT_UNORDERED_MAP_INCLUDED
+
+#include "core.hpp"
+#include "unordered_map.hpp"
+
+#include <mutex>
+#include <utility>
+
+SSTD_BEGIN
+
+// A sstd::unordered_map split into _Shard_Count independent shards
+// Every shard is a normal open addressing table with its own lock,
+// so threads only wait on each other when they hit the same shard
+//
+// The shard is picked by a multiply-shift of the hash, so it doesn't take away any of the bits the shard itself probes with
+// ( the low bits for _Mask_Reduce, the top ones for _Fastrange_Reduce and the control byte, see _Ctrl )
+// Each shard sits on its own cache lines, so two locks never share a line
+// The key is hashed once, the same hash picks the shard and then probes it
+// ( so the shards need to hash like m_Hasher, which they do as long as _Hash is default constructed the same way )
+//
+// Nothing ever hands out a reference into a shard, since it can be rehashed by another thread right after
+// Use visit / update to work on an element in place while the shard is locked
+
+template<
+	typename _KeyT,	// Key type
+	typename _EltT,		// Element type
+	typename _Hash = _Default_Hash<_KeyT>, // Hash function
+	typename _ProbT = _Double_Hash_Prob<_KeyT, _Hash>, // probing function
+	sizet _Shard_Count = 64 // Amount of shards, needs to be a power of 2
+>
+class concurrent_unordered_map {
+	SSTD_STATIC_ASSERT(_Shard_Count > 0 && (_Shard_Count & (_Shard_Count - 1)) == 0, "The shard count needs to be a power of 2");
+public:
+	using map_type = unordered_map<_KeyT, _EltT, _Hash, _ProbT>;
+private:
+	struct alignas(64) _Shard {
+		mutable std::mutex lock;
+		map_type map;
+	};
+public:
+
+	// Default constructor
+	concurrent_unordered_map() SSTD_DEFAULT;
+
+	// Constructor that initialize using a initializer list
+	// std::pair(Key, Element)
+	concurrent_unordered_map(std::initializer_list<std::pair<_KeyT, _EltT> > list) {
+		for (const std::pair<_KeyT, _EltT>& pair : list) {
+			insert(pair.first, pair.second);
+		}
+	}
+
+	concurrent_unordered_map(const concurrent_unordered_map&) = delete;
+	concurrent_unordered_map& operator=(const concurrent_unordered_map&) = delete;
+
+	SSTD_INLINE void insert(const _KeyT& key, const _EltT& elt) {
+		const sizet hash = m_Hasher(key);
+		_Shard& shard = _Shard_Of(hash);
+		std::lock_guard<std::mutex> guard(shard.lock);
+		shard.map._Insert_Or_Assign(key, hash, elt);
+	}
+	SSTD_INLINE void insert(const _KeyT& key, _EltT&& elt) {
+		const sizet hash = m_Hasher(key);
+		_Shard& shard = _Shard_Of(hash);
+		std::lock_guard<std::mutex> guard(shard.lock);
+		shard.map._Insert_Or_Assign(key, hash, std::move(elt));
+	}
+	SSTD_INLINE void insert(const std::pair<_KeyT, _EltT>& pair) {
+		insert(pair.first, pair.second);
+	}
+
+	SSTD_INLINE void erase(const _KeyT& key) {
+		const sizet hash = m_Hasher(key);
+		_Shard& shard = _Shard_Of(hash);
+		std::lock_guard<std::mutex> guard(shard.lock);
+		shard.map._Erase(key, hash);
+	}
+
+	SSTD_INLINE bool contains(const _KeyT& key) const {
+		const sizet hash = m_Hasher(key);
+		const _Shard& shard = _Shard_Of(hash);
+		std::lock_guard<std::mutex> guard(shard.lock);
+		return shard.map._Search_Index(key, hash) != shard.map._End_Index();
+	}
+
+	// Copy the element out, returns false if the key doesn't exist
+	SSTD_INLINE bool find(const _KeyT& key, _EltT& out) const {
+		const sizet hash = m_Hasher(key);
+		const _Shard& shard = _Shard_Of(hash);
+		std::lock_guard<std::mutex> guard(shard.lock);
+		const sizet ind = shard.map._Search_Index(key, hash);
+		if (ind == shard.map._End_Index()) {
+			return false;
+		}
+		out = shard.map._Elt_At(ind);
+		return true;
+	}
+
+	// Call func(elt) while the shard is locked, returns false if the key doesn't exist
+	template<typename _Func>
+	SSTD_INLINE bool visit(const _KeyT& key, _Func&& func) {
+		const sizet hash = m_Hasher(key);
+		_Shard& shard = _Shard_Of(hash);
+		std::lock_guard<std::mutex> guard(shard.lock);
+		const sizet ind = shard.map._Search_Index(key, hash);
+		if (ind == shard.map._End_Index()) {
+			return false;
+		}
+		func(shard.map._Elt_At(ind));
+		return true;
+	}
+
+	// Call func(elt) while the shard is locked,
+	// the element is default constructed first if the key doesn't exist
+	template<typename _Func>
+	SSTD_INLINE void update(const _KeyT& key, _Func&& func) {
+		const sizet hash = m_Hasher(key);
+		_Shard& shard = _Shard_Of(hash);
+		std::lock_guard<std::mutex> guard(shard.lock);
+		const std::pair<sizet, bool> res = shard.map._Find_Or_Prepare_Insert(key, hash);
+		if (!res.second) {
+			map_type::_Construct_Elt(shard.map.m_table, res.first);
+		}
+		func(shard.map._Elt_At(res.first));
+	}
+
+	// Call func(map) on every shard, one shard locked at a time
+	// Good for bulk reads / writes that would otherwise take the lock once per key
+	template<typename _Func>
+	SSTD_INLINE void for_each_shard(_Func&& func) {
+		for (sizet i = 0; i < _Shard_Count; ++i) {
+			std::lock_guard<std::mutex> guard(m_shards[i].lock);
+			func(m_shards[i].map);
+		}
+	}
+	template<typename _Func>
+	SSTD_INLINE void for_each_shard(_Func&& func) const {
+		for (sizet i = 0; i < _Shard_Count; ++i) {
+			std::lock_guard<std::mutex> guard(m_shards[i].lock);
+			func(static_cast<const map_type&>(m_shards[i].map));
+		}
+	}
+
+	// Spread _size slots over the shards
+	SSTD_INLINE void reserve(const sizet& _size) {
+		for_each_shard([&](map_type& map) {
+			map.reserve(_size / _Shard_Count + 1);
+		});
+	}
+
+	SSTD_INLINE void clear() {
+		for_each_shard([](map_type& map) {
+			map.clear();
+		});
+	}
+
+	// Only a snapshot, other threads can change it right after
+	SSTD_INLINE sizet size() const {
+		sizet res = 0;
+		for_each_shard([&](const map_type& map) {
+			res += map.size();
+		});
+		return res;
+	}
+	SSTD_INLINE bool empty() const {
+		return size() == 0;
+	}
+
+	static SSTD_INLINE SSTD_CONSTEXPR sizet shard_count() noexcept {
+		return _Shard_Count;
+	}
+private:
+	_Shard m_shards[_Shard_Count];
+
+	const _Hash m_Hasher{};
+
+	static SSTD_INLINE SSTD_CONSTEXPR uint32 _Shard_Bits() noexcept {
+		uint32 bits = 0;
+		while ((sizet(1) << bits) < _Shard_Count) {
+			++bits;
+		}
+		return bits;
+	}
+
+	static SSTD_INLINE sizet _Shard_Index(const sizet& hash) noexcept {
+		if constexpr (_Shard_Count == 1) {
+			return 0;
+		}
+		else {
+			return static_cast<sizet>((static_cast<uint64>(hash) * 0x9e3779b97f4a7c15ull) >> (64 - _Shard_Bits()));
+		}
+	}
+
+	SSTD_INLINE _Shard& _Shard_Of(const sizet& hash) noexcept {
+		return m_shards[_Shard_Index(hash)];
+	}
+	SSTD_INLINE const _Shard& _Shard_Of(const sizet& hash) const noexcept {
+		return m_shards[_Shard_Index(hash)];
+	}
+};
+
+SSTD_END
+
+#endif
@@ -3,6 +3,13 @@
 
 #include <iostream>
 #include <cassert>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 #define SSTD_BEGIN namespace sstd {
 #define SSTD_END	}
@@ -35,6 +42,71 @@ using sizet = std::size_t;
 
 using Decimal = double;
 
+// -----------------------------------------
+//
+//   Bit helpers
+//
+// -----------------------------------------
+
+// Index of the lowest set bit ( x must not be 0 )
+SSTD_INLINE uint32 _Count_Trailing_Zeros(uint64 x) noexcept {
+#if defined(_MSC_VER)
+	unsigned long ind;
+	_BitScanForward64(&ind, x);
+	return static_cast<uint32>(ind);
+#else
+	return static_cast<uint32>(__builtin_ctzll(x));
+#endif
+}
+
+// Number of set bits
+SSTD_INLINE uint32 _Pop_Count(uint32 x) noexcept {
+#if defined(_MSC_VER)
+	return static_cast<uint32>(__popcnt(x));
+#else
+	return static_cast<uint32>(__builtin_popcount(x));
+#endif
+}
+
+// Round x up to the next power of 2 ( 0 and 1 both become 1 )
+SSTD_INLINE SSTD_CONSTEXPR sizet _Bit_Ceil(sizet x) noexcept {
+	sizet res = 1;
+	while (res < x) {
+		res <<= 1;
+	}
+	return res;
+}
+
+// Ask the cache for the line holding p, without waiting for it
+SSTD_INLINE void _Prefetch(const void* p) noexcept {
+#if defined(_MSC_VER)
+	_mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+	__builtin_prefetch(p);
+#endif
+}
+
+// -----------------------------------------
+//
+//   Type traits
+//
+// -----------------------------------------
+
+// Can a T be moved to another address by copying its bytes, without running anything on the old ones
+// That's what lets vector grow with realloc and shift elements with memmove
+// True for trivially copyable types, specialize this to opt in your own
+// ( most types are, unless they point into themselves or hand their address to someone else,
+//   libstdc++'s std::string points into itself, so it's left out )
+template<typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template<typename T, typename _Deleter>
+struct is_trivially_relocatable<std::unique_ptr<T, _Deleter> > : is_trivially_relocatable<_Deleter> {};
+template<typename T>
+struct is_trivially_relocatable<std::shared_ptr<T> > : std::true_type {};
+template<typename T>
+struct is_trivially_relocatable<std::weak_ptr<T> > : std::true_type {};
+
 SSTD_END
 
-#endif
\ No newline at end of file
+#endif
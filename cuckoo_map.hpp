@@ -0,0 +1,640 @@
+#ifndef SSTD_CUCKOO_MAP_INCLUDED
+#define SSTD_CUCKOO_MAP_INCLUDED
+
+#include "core.hpp"
+#include "hash.hpp"
+#include "Iterator.hpp"
+
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+SSTD_BEGIN
+
+template<typename _KeyT, typename _EltT, typename _Hash>
+class _Cuckoo_Map_Iterator;
+template<typename _KeyT, typename _EltT, typename _Hash>
+class _Cuckoo_Map_Const_Iterator;
+
+// A hash map where every key can only ever be in one of two buckets,
+// so a lookup looks at 2 buckets ( and the stash, only while it isn't empty ), no matter how full the table is
+//
+// Every bucket has 4 slots, and an 8 bit tag per slot ( 0 is empty ) from the top bits of the hash
+// The first bucket comes from the low bits of the hash, the second one is the first bucket xor a hash of the tag,
+// so the other bucket of anything in the table is known from its tag alone, without hashing the key again
+// ( Partial key cuckoo hashing, the 2 hash functions are derived from the single _Hash )
+//
+// Insert takes any free slot of the 2 buckets, if there's none it searches ( breadth first ) for the shortest chain of
+// entries that can each move to their other bucket, ending at a free slot, and moves the whole chain by one
+// A key that still doesn't fit goes into the small stash, and the table only grows once the stash is full too
+//
+// Buckets are aligned to a cache line, a bucket of 4 small slots is exactly one line
+// The hash needs to be a good one, more than 2 buckets + the stash worth of keys with the exact same hash can never fit
+
+template<
+	typename _KeyT,	// Key type
+	typename _EltT,		// Element type
+	typename _Hash = _Default_Hash<_KeyT> // Hash function
+>
+class cuckoo_map {
+public:
+	friend class _Cuckoo_Map_Iterator<_KeyT, _EltT, _Hash>;
+	friend class _Cuckoo_Map_Const_Iterator<_KeyT, _EltT, _Hash>;
+	using iterator = _Cuckoo_Map_Iterator<_KeyT, _EltT, _Hash>;
+	using const_iterator = _Cuckoo_Map_Const_Iterator<_KeyT, _EltT, _Hash>;
+private:
+	struct _Slot {
+		_KeyT key;
+		_EltT elt;
+	};
+	struct _Slot_Storage {
+		alignas(_Slot) unsigned char bytes[sizeof(_Slot)];
+	};
+
+	static SSTD_CONSTEXPR sizet s_ways = 4;
+
+	struct alignas(64) _Bucket {
+		uint8 tags[s_ways];
+		_Slot_Storage slots[s_ways];
+	};
+
+	// The stash is the last s_stash_buckets buckets of the array, only looked at while m_stash_size isn't 0
+	static SSTD_CONSTEXPR sizet s_stash_buckets = 2;
+	// Longest search for a free slot before a key goes into the stash
+	static SSTD_CONSTEXPR sizet s_max_bfs = 512;
+	// Grow before the 2 buckets of new keys are this full on average, the search gets long past that
+	static SSTD_CONSTEXPR Decimal s_max_load_factor = 0.9;
+public:
+
+	// Default constructor
+	cuckoo_map() {
+		_Allocate(4); // just some random magic number
+	}
+
+	// Constructor that initialize using a initializer list
+	// std::pair(Key, Element)
+	cuckoo_map(std::initializer_list<std::pair<_KeyT, _EltT> > list) {
+		_Allocate(_Bucket_Count_For(list.size()));
+		for (const std::pair<_KeyT, _EltT>& pair : list) {
+			insert(pair.first, pair.second);
+		}
+	}
+
+	cuckoo_map(const cuckoo_map&) = delete;
+	cuckoo_map& operator=(const cuckoo_map&) = delete;
+
+	// Move constructor, just takes the buckets
+	// other is left without any, the next insert allocates them
+	cuckoo_map(cuckoo_map&& other) noexcept :
+		m_buckets(std::exchange(other.m_buckets, nullptr)), m_bucket_count(std::exchange(other.m_bucket_count, 0)),
+		m_size(std::exchange(other.m_size, 0)), m_stash_size(std::exchange(other.m_stash_size, 0)), m_Hasher(other.m_Hasher) {
+
+	}
+
+	cuckoo_map& operator=(cuckoo_map&& other) noexcept {
+		if (this != &other) {
+			_Free(m_buckets, m_bucket_count);
+			m_buckets = std::exchange(other.m_buckets, nullptr);
+			m_bucket_count = std::exchange(other.m_bucket_count, 0);
+			m_size = std::exchange(other.m_size, 0);
+			m_stash_size = std::exchange(other.m_stash_size, 0);
+			m_Hasher = other.m_Hasher;
+		}
+		return *this;
+	}
+
+	~cuckoo_map() {
+		_Free(m_buckets, m_bucket_count);
+	}
+
+	SSTD_INLINE void clear() {
+		_Free(m_buckets, m_bucket_count);
+		_Allocate(4);
+	}
+
+	// Insert, or overwrite the element if the key already exists
+	SSTD_INLINE void insert(const _KeyT& key, const _EltT& elt) {
+		insert_or_assign(key, elt);
+	}
+	SSTD_INLINE void insert(const _KeyT& key, _EltT&& elt) {
+		insert_or_assign(key, std::move(elt));
+	}
+	SSTD_INLINE void insert(const std::pair<_KeyT, _EltT>& pair) {
+		insert_or_assign(pair.first, pair.second);
+	}
+
+	// Same as sstd::unordered_map::try_emplace
+	template<typename... _Args>
+	SSTD_INLINE std::pair<iterator, bool> try_emplace(const _KeyT& key, _Args&&... args) {
+		return _Try_Emplace(key, std::forward<_Args>(args)...);
+	}
+	template<typename... _Args>
+	SSTD_INLINE std::pair<iterator, bool> try_emplace(_KeyT&& key, _Args&&... args) {
+		return _Try_Emplace(std::move(key), std::forward<_Args>(args)...);
+	}
+
+	// Same as sstd::unordered_map::insert_or_assign
+	template<typename _M>
+	SSTD_INLINE std::pair<iterator, bool> insert_or_assign(const _KeyT& key, _M&& obj) {
+		return _Insert_Or_Assign(key, std::forward<_M>(obj));
+	}
+	template<typename _M>
+	SSTD_INLINE std::pair<iterator, bool> insert_or_assign(_KeyT&& key, _M&& obj) {
+		return _Insert_Or_Assign(std::move(key), std::forward<_M>(obj));
+	}
+
+	SSTD_INLINE void erase(const _KeyT& key) {
+		const sizet ind = _Find_Index(key, m_Hasher(key));
+		if (ind == _End_Index()) {
+			return;
+		}
+		_Destroy(ind);
+		--m_size;
+		if (ind >= m_bucket_count * s_ways) {
+			--m_stash_size;
+		}
+		else if (m_stash_size) {
+			// There might be room for a stashed key now
+			_Unstash();
+		}
+	}
+
+	SSTD_INLINE iterator find(const _KeyT& key) {
+		return iterator(this, _Find_Index(key, m_Hasher(key)));
+	}
+	SSTD_INLINE const_iterator find(const _KeyT& key) const {
+		return const_iterator(this, _Find_Index(key, m_Hasher(key)));
+	}
+
+	SSTD_INLINE bool contains(const _KeyT& key) const {
+		return _Find_Index(key, m_Hasher(key)) != _End_Index();
+	}
+
+	// Construct a empty value into the table if the key doesn't exist
+	SSTD_INLINE _EltT& operator[](const _KeyT& key) {
+		return _At(_Try_Emplace(key).first.m_ind).elt;
+	}
+	SSTD_INLINE _EltT& operator[](_KeyT&& key) {
+		return _At(_Try_Emplace(std::move(key)).first.m_ind).elt;
+	}
+
+	// Make room for _size elements in total
+	SSTD_INLINE void reserve(const sizet& _size) {
+		const sizet count = _Bucket_Count_For(_size);
+		if (count > m_bucket_count) {
+			_Rehash(count);
+		}
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR sizet size() const noexcept {
+		return m_size;
+	}
+	SSTD_INLINE SSTD_CONSTEXPR bool empty() const noexcept {
+		return m_size == 0;
+	}
+	// Slots in the buckets, without the stash
+	SSTD_INLINE SSTD_CONSTEXPR sizet capacity() const noexcept {
+		return m_bucket_count * s_ways;
+	}
+	SSTD_INLINE SSTD_CONSTEXPR Decimal load_factor() const noexcept {
+		return static_cast<Decimal>(m_size) / (capacity() ? capacity() : 1);
+	}
+	// Keys that didn't fit into either of their buckets
+	SSTD_INLINE SSTD_CONSTEXPR sizet stash_size() const noexcept {
+		return m_stash_size;
+	}
+
+	SSTD_INLINE iterator begin() noexcept {
+		return iterator(this, _Next_Full(0));
+	}
+	SSTD_INLINE const_iterator begin() const noexcept {
+		return const_iterator(this, _Next_Full(0));
+	}
+	SSTD_INLINE iterator end() noexcept {
+		return iterator(this, _End_Index());
+	}
+	SSTD_INLINE const_iterator end() const noexcept {
+		return const_iterator(this, _End_Index());
+	}
+	SSTD_INLINE const_iterator cbegin() const noexcept {
+		return begin();
+	}
+	SSTD_INLINE const_iterator cend() const noexcept {
+		return end();
+	}
+private:
+	// m_bucket_count buckets and then the stash ( nullptr once moved from )
+	_Bucket* m_buckets = nullptr;
+	// A power of 2
+	sizet m_bucket_count = 0;
+	sizet m_size = 0;
+	sizet m_stash_size = 0;
+
+	_Hash m_Hasher{};
+
+	// One step of the breadth first search, the bucket reached by moving slot of the parent bucket
+	struct _Bfs_Node {
+		sizet bucket;
+		int32 parent;
+		uint32 slot;
+	};
+
+	// At least 2, a key needs 2 different buckets
+	static SSTD_INLINE sizet _Bucket_Count_For(const sizet& _size) noexcept {
+		const sizet count = _Bit_Ceil(static_cast<sizet>(_size / (s_ways * s_max_load_factor)) + 1);
+		return count < 2 ? 2 : count;
+	}
+
+	SSTD_INLINE void _Allocate(const sizet& count) {
+		m_buckets = new _Bucket[count + s_stash_buckets]();
+		m_bucket_count = count;
+		m_size = 0;
+		m_stash_size = 0;
+	}
+
+	SSTD_INLINE void _Free(_Bucket* buckets, const sizet& count) noexcept {
+		if (buckets == nullptr) {
+			return;
+		}
+		for (sizet b = 0; b < count + s_stash_buckets; ++b) {
+			for (sizet s = 0; s < s_ways; ++s) {
+				if (buckets[b].tags[s]) {
+					_Slot_Of(buckets, b, s).~_Slot();
+				}
+			}
+		}
+		delete[] buckets;
+	}
+
+	// Tag of a hash, never 0
+	static SSTD_INLINE SSTD_CONSTEXPR uint8 _Tag(const sizet& hash) noexcept {
+		const uint8 tag = static_cast<uint8>(static_cast<uint64>(hash) >> 56);
+		return tag ? tag : 1;
+	}
+
+	SSTD_INLINE sizet _First_Bucket(const sizet& hash) const noexcept {
+		return hash & (m_bucket_count - 1);
+	}
+	// The other bucket of something with this tag in bucket, works both ways
+	// The offset is never 0, so the 2 buckets of a key are never the same one
+	SSTD_INLINE sizet _Other_Bucket(const sizet& bucket, const uint8& tag) const noexcept {
+		const sizet offset = static_cast<sizet>((tag * 0xc6a4a7935bd1e995ull) >> 32) & (m_bucket_count - 1);
+		return bucket ^ (offset ? offset : 1);
+	}
+
+	// One bit ( the top bit of the byte ) per slot whose tag is tag, in a single 32 bit compare
+	// A tag right above a match can show up too, the key compare sorts those out
+	static SSTD_INLINE uint32 _Match(const _Bucket& bucket, const uint8& tag) noexcept {
+		uint32 tags;
+		std::memcpy(&tags, bucket.tags, sizeof(tags));
+		const uint32 x = tags ^ (0x01010101u * tag);
+		return (x - 0x01010101u) & ~x & 0x80808080u;
+	}
+
+	static SSTD_INLINE _Slot& _Slot_Of(_Bucket* buckets, const sizet& b, const sizet& s) noexcept {
+		return *reinterpret_cast<_Slot*>(buckets[b].slots[s].bytes);
+	}
+	// Slots are indexed bucket * s_ways + slot, the stash comes right after the buckets
+	SSTD_INLINE _Slot& _At(const sizet& ind) const noexcept {
+		return _Slot_Of(m_buckets, ind / s_ways, ind % s_ways);
+	}
+
+	// A moved-from map has no slots at all, not even the stash
+	SSTD_INLINE SSTD_CONSTEXPR sizet _End_Index() const noexcept {
+		return m_buckets != nullptr ? (m_bucket_count + s_stash_buckets) * s_ways : 0;
+	}
+
+	SSTD_INLINE sizet _Next_Full(sizet ind) const noexcept {
+		for (; ind < _End_Index(); ++ind) {
+			if (m_buckets[ind / s_ways].tags[ind % s_ways]) {
+				break;
+			}
+		}
+		return ind;
+	}
+
+	// The key in bucket b, or s_ways
+	SSTD_INLINE sizet _Find_In(const sizet& b, const _KeyT& key, const uint8& tag) const {
+		for (uint32 mask = _Match(m_buckets[b], tag); mask; mask &= mask - 1) {
+			const sizet s = _Count_Trailing_Zeros(mask) >> 3;
+			if (m_buckets[b].tags[s] == tag && _Slot_Of(m_buckets, b, s).key == key) {
+				return s;
+			}
+		}
+		return s_ways;
+	}
+
+	SSTD_INLINE sizet _Find_Index(const _KeyT& key, const sizet& hash) const {
+		if (m_buckets == nullptr) {
+			return _End_Index();
+		}
+		const uint8 tag = _Tag(hash);
+		const sizet b1 = _First_Bucket(hash);
+		const sizet b2 = _Other_Bucket(b1, tag);
+		_Prefetch(m_buckets + b2);
+		sizet s = _Find_In(b1, key, tag);
+		if (s != s_ways) {
+			return b1 * s_ways + s;
+		}
+		s = _Find_In(b2, key, tag);
+		if (s != s_ways) {
+			return b2 * s_ways + s;
+		}
+		if (m_stash_size) {
+			for (sizet b = m_bucket_count; b < m_bucket_count + s_stash_buckets; ++b) {
+				s = _Find_In(b, key, tag);
+				if (s != s_ways) {
+					return b * s_ways + s;
+				}
+			}
+		}
+		return _End_Index();
+	}
+
+	// A free slot in bucket b, or s_ways
+	SSTD_INLINE sizet _Free_In(const sizet& b) const noexcept {
+		const uint32 mask = _Match(m_buckets[b], 0);
+		return mask ? _Count_Trailing_Zeros(mask) >> 3 : s_ways;
+	}
+
+	// Free a slot in one of the 2 buckets of the hash, moving other entries along a cuckoo path if needed
+	// Returns the slot index, or _End_Index() if there's no path within s_max_bfs steps
+	SSTD_INLINE sizet _Make_Room(const sizet& hash) {
+		const uint8 tag = _Tag(hash);
+		_Bfs_Node queue[s_max_bfs];
+		sizet tail = 0;
+		queue[tail++] = { _First_Bucket(hash), -1, 0 };
+		queue[tail++] = { _Other_Bucket(queue[0].bucket, tag), -1, 0 };
+		for (sizet head = 0; head < tail; ++head) {
+			const sizet b = queue[head].bucket;
+			sizet free = _Free_In(b);
+			if (free != s_ways) {
+				// Walk back to the root, every entry on the path moves one step into the slot freed after it
+				int32 node = static_cast<int32>(head);
+				while (queue[node].parent >= 0) {
+					const _Bfs_Node& parent = queue[queue[node].parent];
+					_Move(parent.bucket, queue[node].slot, queue[node].bucket, free);
+					free = queue[node].slot;
+					node = queue[node].parent;
+				}
+				return queue[node].bucket * s_ways + free;
+			}
+			for (uint32 s = 0; s < s_ways && tail < s_max_bfs; ++s) {
+				queue[tail++] = { _Other_Bucket(b, m_buckets[b].tags[s]), static_cast<int32>(head), s };
+			}
+		}
+		return _End_Index();
+	}
+
+	// Move the entry in slot s of bucket from to the free slot t of bucket to
+	SSTD_INLINE void _Move(const sizet& from, const sizet& s, const sizet& to, const sizet& t) {
+		SSTD_ASSERT(_Other_Bucket(from, m_buckets[from].tags[s]) == to && m_buckets[to].tags[t] == 0);
+		_Slot& src = _Slot_Of(m_buckets, from, s);
+		new (&_Slot_Of(m_buckets, to, t)) _Slot{ std::move(src.key), std::move(src.elt) };
+		src.~_Slot();
+		m_buckets[to].tags[t] = m_buckets[from].tags[s];
+		m_buckets[from].tags[s] = 0;
+	}
+
+	SSTD_INLINE void _Destroy(const sizet& ind) noexcept {
+		_At(ind).~_Slot();
+		m_buckets[ind / s_ways].tags[ind % s_ways] = 0;
+	}
+
+	// A slot for a new key with this hash, with the tag already set, growing the table if nothing else works
+	SSTD_INLINE sizet _Claim_Slot(const sizet& hash) {
+		if (m_buckets == nullptr) {
+			_Allocate(4);
+		}
+		if (static_cast<Decimal>(m_size + 1) > capacity() * s_max_load_factor) {
+			_Rehash(m_bucket_count * 2);
+		}
+		sizet ind = _Take_Slot(hash);
+		while (ind == _End_Index()) {
+			// A good hash doesn't run out of room this empty, but keys that all share a hash fill their 2 buckets and the stash
+			// no matter how big the table gets
+			if (static_cast<Decimal>(m_size) < capacity() * s_max_load_factor / 4) {
+				throw std::overflow_error("Too many keys with the same hash, check the hash function");
+			}
+			_Rehash(m_bucket_count * 2);
+			ind = _Take_Slot(hash);
+		}
+		return ind;
+	}
+
+	// A free slot in the buckets of hash ( after moving others out of the way ) or in the stash, _End_Index() if there's none
+	SSTD_INLINE sizet _Take_Slot(const sizet& hash) {
+		sizet ind = _Make_Room(hash);
+		if (ind == _End_Index() && m_stash_size < s_stash_buckets * s_ways) {
+			for (sizet b = m_bucket_count; b < m_bucket_count + s_stash_buckets; ++b) {
+				const sizet s = _Free_In(b);
+				if (s != s_ways) {
+					ind = b * s_ways + s;
+					++m_stash_size;
+					break;
+				}
+			}
+		}
+		if (ind != _End_Index()) {
+			m_buckets[ind / s_ways].tags[ind % s_ways] = _Tag(hash);
+			++m_size;
+		}
+		return ind;
+	}
+
+	// Move everything into count buckets
+	// A key that doesn't fit grows the new table again right away instead of throwing halfway through
+	// ( they all fit before, so this ends )
+	SSTD_INLINE void _Rehash(const sizet& count) {
+		_Bucket* old = m_buckets;
+		const sizet old_count = m_bucket_count;
+		_Allocate(count);
+		if (old == nullptr) {
+			return;
+		}
+		for (sizet b = 0; b < old_count + s_stash_buckets; ++b) {
+			for (sizet s = 0; s < s_ways; ++s) {
+				if (old[b].tags[s] == 0) {
+					continue;
+				}
+				_Slot& slot = _Slot_Of(old, b, s);
+				const sizet hash = m_Hasher(slot.key);
+				sizet ind = _Take_Slot(hash);
+				while (ind == _End_Index()) {
+					_Rehash(m_bucket_count * 2);
+					ind = _Take_Slot(hash);
+				}
+				new (&_At(ind)) _Slot{ std::move(slot.key), std::move(slot.elt) };
+				slot.~_Slot();
+				old[b].tags[s] = 0;
+			}
+		}
+		delete[] old;
+	}
+
+	// Move stashed keys back into their buckets, if there's room now
+	SSTD_INLINE void _Unstash() {
+		for (sizet b = m_bucket_count; b < m_bucket_count + s_stash_buckets; ++b) {
+			for (sizet s = 0; s < s_ways; ++s) {
+				if (m_buckets[b].tags[s] == 0) {
+					continue;
+				}
+				const sizet hash = m_Hasher(_Slot_Of(m_buckets, b, s).key);
+				const sizet b1 = _First_Bucket(hash);
+				const sizet b2 = _Other_Bucket(b1, _Tag(hash));
+				sizet free = _Free_In(b1);
+				sizet to = b1;
+				if (free == s_ways) {
+					free = _Free_In(b2);
+					to = b2;
+				}
+				if (free != s_ways) {
+					_Slot& src = _Slot_Of(m_buckets, b, s);
+					new (&_Slot_Of(m_buckets, to, free)) _Slot{ std::move(src.key), std::move(src.elt) };
+					src.~_Slot();
+					m_buckets[to].tags[free] = m_buckets[b].tags[s];
+					m_buckets[b].tags[s] = 0;
+					--m_stash_size;
+				}
+			}
+		}
+	}
+
+	template<typename _K, typename... _Args>
+	SSTD_INLINE std::pair<iterator, bool> _Try_Emplace(_K&& key, _Args&&... args) {
+		const sizet hash = m_Hasher(key);
+		const sizet found = _Find_Index(key, hash);
+		if (found != _End_Index()) {
+			return { iterator(this, found), false };
+		}
+		const sizet ind = _Claim_Slot(hash);
+		new (&_At(ind)) _Slot{ _KeyT(std::forward<_K>(key)), _EltT(std::forward<_Args>(args)...) };
+		return { iterator(this, ind), true };
+	}
+
+	template<typename _K, typename _M>
+	SSTD_INLINE std::pair<iterator, bool> _Insert_Or_Assign(_K&& key, _M&& obj) {
+		const sizet hash = m_Hasher(key);
+		const sizet found = _Find_Index(key, hash);
+		if (found != _End_Index()) {
+			_At(found).elt = std::forward<_M>(obj);
+			return { iterator(this, found), false };
+		}
+		const sizet ind = _Claim_Slot(hash);
+		new (&_At(ind)) _Slot{ _KeyT(std::forward<_K>(key)), _EltT(std::forward<_M>(obj)) };
+		return { iterator(this, ind), true };
+	}
+};
+
+// -----------------------------------------
+//
+//   Forward Iterator
+//
+// -----------------------------------------
+
+template<
+	typename _KeyT,
+	typename _EltT,
+	typename _Hash
+>
+class _Cuckoo_Map_Iterator : public forward_iterator<std::pair<_KeyT, _EltT> > {
+	friend class cuckoo_map<_KeyT, _EltT, _Hash>;
+	friend class _Cuckoo_Map_Const_Iterator<_KeyT, _EltT, _Hash>;
+public:
+	using reference = std::pair<const _KeyT&, _EltT&>;
+	using pointer = _Arrow_Proxy<reference>;
+
+	_Cuckoo_Map_Iterator(cuckoo_map<_KeyT, _EltT, _Hash>* _map, sizet ind) :
+		m_map(_map), m_ind(ind) {
+
+	}
+
+	SSTD_INLINE _Cuckoo_Map_Iterator& operator++() noexcept {
+		m_ind = m_map->_Next_Full(m_ind + 1);
+		return *this;
+	}
+	SSTD_INLINE _Cuckoo_Map_Iterator operator++(int) noexcept {
+		_Cuckoo_Map_Iterator tmp = *this;
+		m_ind = m_map->_Next_Full(m_ind + 1);
+		return tmp;
+	}
+
+	SSTD_INLINE reference operator*() const noexcept {
+		return { m_map->_At(m_ind).key, m_map->_At(m_ind).elt };
+	}
+	SSTD_INLINE pointer operator->() const noexcept {
+		return { **this };
+	}
+
+	SSTD_INLINE bool operator==(const _Cuckoo_Map_Iterator& other) const noexcept {
+		return m_map == other.m_map && m_ind == other.m_ind;
+	}
+
+	SSTD_INLINE bool operator!=(const _Cuckoo_Map_Iterator& other) const noexcept {
+		return m_map != other.m_map || m_ind != other.m_ind;
+	}
+private:
+	cuckoo_map<_KeyT, _EltT, _Hash>* m_map;
+	sizet m_ind;
+};
+
+// -----------------------------------------
+//
+//   Const Forward Iterator
+//
+// -----------------------------------------
+
+template<
+	typename _KeyT,
+	typename _EltT,
+	typename _Hash
+>
+class _Cuckoo_Map_Const_Iterator : public const_forward_iterator<std::pair<_KeyT, _EltT> > {
+	friend class cuckoo_map<_KeyT, _EltT, _Hash>;
+public:
+	using reference = std::pair<const _KeyT&, const _EltT&>;
+	using pointer = _Arrow_Proxy<reference>;
+
+	_Cuckoo_Map_Const_Iterator(const cuckoo_map<_KeyT, _EltT, _Hash>* _map, sizet ind) :
+		m_map(_map), m_ind(ind) {
+
+	}
+	_Cuckoo_Map_Const_Iterator(_Cuckoo_Map_Iterator<_KeyT, _EltT, _Hash> itr) :
+		m_map(itr.m_map), m_ind(itr.m_ind) {
+
+	}
+
+	SSTD_INLINE _Cuckoo_Map_Const_Iterator& operator++() noexcept {
+		m_ind = m_map->_Next_Full(m_ind + 1);
+		return *this;
+	}
+	SSTD_INLINE _Cuckoo_Map_Const_Iterator operator++(int) noexcept {
+		_Cuckoo_Map_Const_Iterator tmp = *this;
+		m_ind = m_map->_Next_Full(m_ind + 1);
+		return tmp;
+	}
+
+	SSTD_INLINE reference operator*() const noexcept {
+		return { m_map->_At(m_ind).key, m_map->_At(m_ind).elt };
+	}
+	SSTD_INLINE pointer operator->() const noexcept {
+		return { **this };
+	}
+
+	SSTD_INLINE bool operator==(const _Cuckoo_Map_Const_Iterator& other) const noexcept {
+		return m_map == other.m_map && m_ind == other.m_ind;
+	}
+
+	SSTD_INLINE bool operator!=(const _Cuckoo_Map_Const_Iterator& other) const noexcept {
+		return m_map != other.m_map || m_ind != other.m_ind;
+	}
+private:
+	const cuckoo_map<_KeyT, _EltT, _Hash>* m_map;
+	sizet m_ind;
+};
+
+SSTD_END
+
+#endif
@@ -0,0 +1,243 @@
+#ifndef SSTD_FROZEN_MAP_INCLUDED
+#define SSTD_FROZEN_MAP_INCLUDED
+
+#include "core.hpp"
+
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+SSTD_BEGIN
+
+// -----------------------------------------
+//
+//   Compile time hash
+//
+// -----------------------------------------
+
+// The hashes in hash.hpp aren't constexpr, these are
+// A custom one needs the same static constexpr hash(key, seed)
+
+SSTD_INLINE SSTD_CONSTEXPR uint64 _Frozen_Mix(uint64 x) noexcept {
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdull;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ull;
+	x ^= x >> 33;
+	return x;
+}
+
+template<typename T, typename = void>
+struct _Frozen_Hash {
+	SSTD_STATIC_ASSERT(std::is_integral<T>::value || std::is_enum<T>::value,
+		"No constexpr hash for this key type, pass one to frozen_map");
+	static SSTD_INLINE SSTD_CONSTEXPR uint64 hash(const T& key, const uint64& seed) noexcept {
+		return _Frozen_Mix(static_cast<uint64>(key) ^ seed);
+	}
+};
+template<typename _CharT>
+struct _Frozen_Hash<std::basic_string_view<_CharT> > {
+	// FNV-1a, one character at a time
+	static SSTD_INLINE SSTD_CONSTEXPR uint64 hash(const std::basic_string_view<_CharT>& key, const uint64& seed) noexcept {
+		uint64 res = 0xcbf29ce484222325ull ^ seed;
+		for (sizet i = 0; i < key.size(); ++i) {
+			res ^= static_cast<uint64>(key[i]);
+			res *= 0x100000001b3ull;
+		}
+		return _Frozen_Mix(res);
+	}
+};
+
+// -----------------------------------------
+//
+//   Layout
+//
+// -----------------------------------------
+
+// Sizes of a frozen_map of _Count keys
+// The keys go into buckets of ~4 first, and every bucket gets the displacement that puts all of its keys into free slots,
+// with a quarter of the slots left over so the last buckets still find room quickly
+template<sizet _Count>
+struct _Frozen_Layout {
+	static constexpr sizet slots = _Bit_Ceil(_Count + _Count / 3 + 1);
+	static constexpr sizet buckets = _Count / 4 + 1;
+	// Try this many displacements for a bucket before starting over with another seed
+	static constexpr uint32 max_displacement = static_cast<uint32>(slots * 16);
+	static constexpr uint32 max_seeds = 16;
+};
+
+template<typename _KeyT, typename _EltT>
+struct _Frozen_Item {
+	_KeyT key;
+	_EltT elt;
+};
+
+// -----------------------------------------
+//
+//   Frozen map
+//
+// -----------------------------------------
+
+// A map of keys known at compile time, built by a minimal-ish perfect hash ( hash and displace )
+// Built in a constexpr, so there's nothing to do at startup and nothing on the heap:
+//
+//   constexpr auto opcodes = sstd::make_frozen_map<std::string_view, int>({ { "add", 1 }, { "sub", 2 } });
+//   static_assert(opcodes.at("sub") == 2);
+//
+// A lookup is one hash, a read of the displacement of its bucket, and one key compare
+// Duplicate keys ( or keys that the builder can't place ) fail the constexpr with a throw
+
+template<
+	typename _KeyT,	// Key type
+	typename _EltT,		// Element type
+	sizet _Count,		// Number of keys
+	typename _Hash = _Frozen_Hash<_KeyT> // constexpr hash function
+>
+class frozen_map {
+	SSTD_STATIC_ASSERT(_Count > 0);
+	using _Layout = _Frozen_Layout<_Count>;
+public:
+	using value_type = _Frozen_Item<_KeyT, _EltT>;
+	using iterator = const value_type*;
+	using const_iterator = const value_type*;
+
+	SSTD_CONSTEXPR frozen_map(const std::pair<_KeyT, _EltT>(&items)[_Count]) {
+		for (sizet i = 0; i < _Count; ++i) {
+			m_items[i].key = items[i].first;
+			m_items[i].elt = items[i].second;
+		}
+		for (uint32 attempt = 0; attempt < _Layout::max_seeds; ++attempt) {
+			m_seed = _Frozen_Mix(0x9e3779b97f4a7c15ull * (attempt + 1));
+			if (_Build()) {
+				return;
+			}
+		}
+		throw std::logic_error("frozen_map: couldn't find a perfect hash");
+	}
+
+	// nullptr if the key doesn't exist
+	SSTD_INLINE SSTD_CONSTEXPR const _EltT* find(const _KeyT& key) const noexcept {
+		const uint64 hash = _Hash::hash(key, m_seed);
+		const uint32 ind = m_index[_Slot_Of(hash, m_disp[_Bucket_Of(hash)])];
+		return ind != _Count && m_items[ind].key == key ? &m_items[ind].elt : nullptr;
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR bool contains(const _KeyT& key) const noexcept {
+		return find(key) != nullptr;
+	}
+
+	// Throws std::out_of_range if the key doesn't exist
+	SSTD_INLINE SSTD_CONSTEXPR const _EltT& at(const _KeyT& key) const {
+		const _EltT* elt = find(key);
+		if (elt == nullptr) {
+			throw std::out_of_range("frozen_map: key doesn't exist");
+		}
+		return *elt;
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR sizet size() const noexcept {
+		return _Count;
+	}
+	SSTD_INLINE SSTD_CONSTEXPR bool empty() const noexcept {
+		return false;
+	}
+
+	// In the order the keys were given
+	SSTD_INLINE SSTD_CONSTEXPR const_iterator begin() const noexcept {
+		return m_items;
+	}
+	SSTD_INLINE SSTD_CONSTEXPR const_iterator end() const noexcept {
+		return m_items + _Count;
+	}
+private:
+	value_type m_items[_Count] = {};
+	// Displacement of every bucket
+	uint32 m_disp[_Layout::buckets] = {};
+	// Item in every slot, _Count if it's free
+	uint32 m_index[_Layout::slots] = {};
+	uint64 m_seed = 0;
+
+	// fastrange on the high half, the slot reads the low bits through _Frozen_Mix
+	static SSTD_INLINE SSTD_CONSTEXPR sizet _Bucket_Of(const uint64& hash) noexcept {
+		return static_cast<sizet>(((hash >> 32) * _Layout::buckets) >> 32);
+	}
+	static SSTD_INLINE SSTD_CONSTEXPR sizet _Slot_Of(const uint64& hash, const uint32& disp) noexcept {
+		return static_cast<sizet>(_Frozen_Mix(hash ^ (disp * 0x9e3779b97f4a7c15ull)) & (_Layout::slots - 1));
+	}
+
+	// Place every key with m_seed, false if some bucket has no displacement that fits
+	SSTD_CONSTEXPR bool _Build() {
+		uint64 hashes[_Count] = {};
+		sizet bucket_of[_Count] = {};
+		// Keys of bucket b are order[start[b], start[b + 1])
+		sizet start[_Layout::buckets + 1] = {};
+		sizet order[_Count] = {};
+		sizet largest = 0;
+		for (sizet i = 0; i < _Count; ++i) {
+			hashes[i] = _Hash::hash(m_items[i].key, m_seed);
+			bucket_of[i] = _Bucket_Of(hashes[i]);
+			++start[bucket_of[i] + 1];
+		}
+		for (sizet b = 0; b < _Layout::buckets; ++b) {
+			largest = start[b + 1] > largest ? start[b + 1] : largest;
+			start[b + 1] += start[b];
+		}
+		sizet fill[_Layout::buckets] = {};
+		for (sizet i = 0; i < _Count; ++i) {
+			order[start[bucket_of[i]] + fill[bucket_of[i]]++] = i;
+		}
+		for (sizet s = 0; s < _Layout::slots; ++s) {
+			m_index[s] = static_cast<uint32>(_Count);
+		}
+		// Biggest buckets first, while most slots are still free
+		for (sizet size = largest; size > 0; --size) {
+			for (sizet b = 0; b < _Layout::buckets; ++b) {
+				if (start[b + 1] - start[b] == size && !_Place(hashes, order + start[b], size, b)) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	// Find the displacement that puts keys[0, count) of bucket b into free slots, all different
+	SSTD_CONSTEXPR bool _Place(const uint64 (&hashes)[_Count], const sizet* keys, const sizet& count, const sizet& b) {
+		// Equal keys end up in the same bucket
+		for (sizet i = 0; i < count; ++i) {
+			for (sizet j = 0; j < i; ++j) {
+				if (hashes[keys[i]] == hashes[keys[j]] && m_items[keys[i]].key == m_items[keys[j]].key) {
+					throw std::logic_error("frozen_map: duplicate key");
+				}
+			}
+		}
+		for (uint32 disp = 0; disp < _Layout::max_displacement; ++disp) {
+			bool fits = true;
+			for (sizet i = 0; i < count && fits; ++i) {
+				const sizet slot = _Slot_Of(hashes[keys[i]], disp);
+				fits = m_index[slot] == _Count;
+				for (sizet j = 0; j < i && fits; ++j) {
+					fits = _Slot_Of(hashes[keys[j]], disp) != slot;
+				}
+			}
+			if (fits) {
+				m_disp[b] = disp;
+				for (sizet i = 0; i < count; ++i) {
+					m_index[_Slot_Of(hashes[keys[i]], disp)] = static_cast<uint32>(keys[i]);
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+// Build a frozen_map from a braced list of pairs, _Count comes from the list
+template<typename _KeyT, typename _EltT, typename _Hash = _Frozen_Hash<_KeyT>, sizet _Count>
+SSTD_INLINE SSTD_CONSTEXPR frozen_map<_KeyT, _EltT, _Count, _Hash> make_frozen_map(const std::pair<_KeyT, _EltT>(&items)[_Count]) {
+	return frozen_map<_KeyT, _EltT, _Count, _Hash>(items);
+}
+
+SSTD_END
+
+#endif
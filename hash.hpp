@@ -0,0 +1,382 @@
+#ifndef SSTD_HASH_INCLUDED
+#define SSTD_HASH_INCLUDED
+
+#include "core.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#define SSTD_HASH_AVX2
+#include <immintrin.h>
+#endif
+
+SSTD_BEGIN
+
+// -----------------------------------------
+//
+//   Mixing
+//
+// -----------------------------------------
+
+// Full 64 x 64 -> 128 bit multiply, a gets the low half and b the high half
+SSTD_INLINE void _Mum(uint64& a, uint64& b) noexcept {
+#if defined(__SIZEOF_INT128__)
+	const unsigned __int128 res = static_cast<unsigned __int128>(a) * b;
+	a = static_cast<uint64>(res);
+	b = static_cast<uint64>(res >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	a = _umul128(a, b, &b);
+#else
+	const uint64 ha = a >> 32, la = static_cast<uint32>(a);
+	const uint64 hb = b >> 32, lb = static_cast<uint32>(b);
+	const uint64 hh = ha * hb, hl = ha * lb, lh = la * hb, ll = la * lb;
+	const uint64 mid = (ll >> 32) + static_cast<uint32>(hl) + static_cast<uint32>(lh);
+	a = (mid << 32) | static_cast<uint32>(ll);
+	b = hh + (hl >> 32) + (lh >> 32) + (mid >> 32);
+#endif
+}
+
+// Multiply and fold the two halves back together
+// Every input bit ends up affecting the top and the bottom bits of the result,
+// which is exactly what the control byte ( top 7 bits ) and the probing ( bottom bits ) need
+SSTD_INLINE uint64 _Mix(uint64 a, uint64 b) noexcept {
+	_Mum(a, b);
+	return a ^ b;
+}
+
+// Constants from wyhash
+SSTD_CONSTEXPR uint64 s_hash_secret[4] = {
+	0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull
+};
+
+// The seed every hasher starts from, picked once per process,
+// so nobody can build a set of keys that collide in every run ( hash flooding )
+// Define SSTD_HASH_SEED to get the same hashes in every run ( Say for a table saved to disk )
+SSTD_INLINE uint64 _Process_Seed() noexcept {
+#if defined(SSTD_HASH_SEED)
+	return static_cast<uint64>(SSTD_HASH_SEED);
+#else
+	static const uint64 seed = []() noexcept {
+		// Where the stack and the binary got loaded ( ASLR ) and the time we started
+		static const int anchor = 0;
+		int local = 0;
+		const uint64 addr = static_cast<uint64>(reinterpret_cast<std::uintptr_t>(&anchor));
+		const uint64 stack = static_cast<uint64>(reinterpret_cast<std::uintptr_t>(&local));
+		const uint64 time = static_cast<uint64>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+		return _Mix(_Mix(addr ^ s_hash_secret[0], stack ^ s_hash_secret[1]), time ^ s_hash_secret[2]);
+	}();
+	return seed;
+#endif
+}
+
+// -----------------------------------------
+//
+//   Byte hashing
+//
+// -----------------------------------------
+
+SSTD_INLINE uint64 _Read_8(const uint8* p) noexcept {
+	uint64 res;
+	std::memcpy(&res, p, 8);
+	return res;
+}
+SSTD_INLINE uint64 _Read_4(const uint8* p) noexcept {
+	uint32 res;
+	std::memcpy(&res, p, 4);
+	return res;
+}
+// 1 to 3 bytes
+SSTD_INLINE uint64 _Read_Small(const uint8* p, const sizet& len) noexcept {
+	return (static_cast<uint64>(p[0]) << 16) | (static_cast<uint64>(p[len >> 1]) << 8) | p[len - 1];
+}
+
+// wyhash ( final version 4 ), short inputs take a single multiply,
+// longer ones walk 48 bytes at a time in 3 independent lanes
+SSTD_INLINE uint64 _Hash_Short(const uint8* p, sizet len, uint64 seed) noexcept {
+	const sizet full_len = len;
+	seed ^= _Mix(seed ^ s_hash_secret[0], s_hash_secret[1]);
+	uint64 a, b;
+	if (len <= 16) {
+		if (len >= 4) {
+			const sizet off = (len >> 3) << 2;
+			a = (_Read_4(p) << 32) | _Read_4(p + off);
+			b = (_Read_4(p + len - 4) << 32) | _Read_4(p + len - 4 - off);
+		}
+		else if (len > 0) {
+			a = _Read_Small(p, len);
+			b = 0;
+		}
+		else {
+			a = b = 0;
+		}
+	}
+	else {
+		if (len > 48) {
+			uint64 see1 = seed, see2 = seed;
+			do {
+				seed = _Mix(_Read_8(p) ^ s_hash_secret[1], _Read_8(p + 8) ^ seed);
+				see1 = _Mix(_Read_8(p + 16) ^ s_hash_secret[2], _Read_8(p + 24) ^ see1);
+				see2 = _Mix(_Read_8(p + 32) ^ s_hash_secret[3], _Read_8(p + 40) ^ see2);
+				p += 48;
+				len -= 48;
+			} while (len > 48);
+			seed ^= see1 ^ see2;
+		}
+		while (len > 16) {
+			seed = _Mix(_Read_8(p) ^ s_hash_secret[1], _Read_8(p + 8) ^ seed);
+			p += 16;
+			len -= 16;
+		}
+		a = _Read_8(p + len - 16);
+		b = _Read_8(p + len - 8);
+	}
+	a ^= s_hash_secret[1];
+	b ^= seed;
+	_Mum(a, b);
+	return _Mix(a ^ s_hash_secret[0] ^ full_len, b ^ s_hash_secret[1]);
+}
+
+// Long inputs with AVX2
+// 8 lanes of xxh3 style multiply accumulate, 4 of them in one register,
+// which beats the 3 scalar lanes of wyhash once the input is long enough
+// Without AVX2 wyhash is as fast as it gets, so there is no long path at all
+// ( So the hash of anything that's s_hash_long or longer depends on the instruction set,
+//   that's fine as long as every process that shares hashes was built the same way )
+#if defined(SSTD_HASH_AVX2)
+
+// Inputs from this size on go through _Hash_Long
+SSTD_CONSTEXPR sizet s_hash_long = 1024;
+// One stripe is 8 lanes of 8 bytes, and the accumulators get scrambled after every block of 8 stripes
+SSTD_CONSTEXPR sizet s_hash_stripe = 64;
+SSTD_CONSTEXPR sizet s_hash_block = 8 * s_hash_stripe;
+
+// Key of every lane, stored twice so stripe s can load its keys rotated by s lanes
+// ( Otherwise two stripes inside a block could be swapped without changing the hash )
+SSTD_CONSTEXPR uint64 s_hash_lane_keys[16] = {
+	0x07c3e62447ce57e9ull, 0x2ec746997017125full, 0x1f1d1f01a9d9a511ull, 0xe46893867c089f4full,
+	0x86056a0acb0b79a3ull, 0x87cfffacf078f425ull, 0xc0df8eb985855a47ull, 0xf13a2d6e8e1ae977ull,
+	0x07c3e62447ce57e9ull, 0x2ec746997017125full, 0x1f1d1f01a9d9a511ull, 0xe46893867c089f4full,
+	0x86056a0acb0b79a3ull, 0x87cfffacf078f425ull, 0xc0df8eb985855a47ull, 0xf13a2d6e8e1ae977ull
+};
+SSTD_CONSTEXPR uint64 s_hash_scramble_key = 0xdb0af0c78dab8a6dull;
+SSTD_CONSTEXPR uint32 s_hash_scramble_prime = 0x9e3779b1u;
+
+// The 8 accumulators of _Hash_Long, kept in registers while the stripes go by
+// Runs the xxh3 stripe accumulate, for every lane j:
+//   acc[j ^ 1] += data[j]
+//   acc[j] += low 32 bits of ( data[j] ^ key[j] ) * high 32 bits of ( data[j] ^ key[j] )
+// and the scramble after every block:
+//   acc[j] = ( acc[j] ^ ( acc[j] >> 47 ) ^ scramble key ) * scramble prime
+// ( Both registers are spelled out, a loop over an array of them ends up on the stack )
+struct _Hash_Lanes {
+	__m256i acc0, acc1;
+
+	SSTD_EXPLICIT _Hash_Lanes(const uint64* init) noexcept :
+		acc0(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(init))),
+		acc1(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(init + 4))) {
+
+	}
+	SSTD_INLINE void store(uint64* out) const noexcept {
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), acc0);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 4), acc1);
+	}
+	SSTD_INLINE void stripe(const uint8* p, const uint64* keys) noexcept {
+		_Stripe(acc0, p, keys);
+		_Stripe(acc1, p + 32, keys + 4);
+	}
+	SSTD_INLINE void scramble() noexcept {
+		_Scramble(acc0);
+		_Scramble(acc1);
+	}
+private:
+	static SSTD_INLINE void _Stripe(__m256i& acc, const uint8* p, const uint64* keys) noexcept {
+		const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+		const __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys));
+		const __m256i data_key = _mm256_xor_si256(data, key);
+		const __m256i product = _mm256_mul_epu32(data_key, _mm256_srli_epi64(data_key, 32));
+		const __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+		acc = _mm256_add_epi64(acc, _mm256_add_epi64(product, swapped));
+	}
+	static SSTD_INLINE void _Scramble(__m256i& acc) noexcept {
+		const __m256i key = _mm256_set1_epi64x(static_cast<long long>(s_hash_scramble_key));
+		const __m256i prime = _mm256_set1_epi32(static_cast<int>(s_hash_scramble_prime));
+		const __m256i a = _mm256_xor_si256(_mm256_xor_si256(acc, _mm256_srli_epi64(acc, 47)), key);
+		const __m256i low = _mm256_mul_epu32(a, prime);
+		const __m256i high = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime);
+		acc = _mm256_add_epi64(low, _mm256_slli_epi64(high, 32));
+	}
+};
+
+// The tail that doesn't fill a stripe goes through wyhash, seeded with the lanes
+SSTD_INLINE uint64 _Hash_Long(const uint8* p, const sizet& len, const uint64& seed) noexcept {
+	uint64 keys[16];
+	uint64 acc[8];
+	for (sizet j = 0; j < 16; ++j) {
+		keys[j] = s_hash_lane_keys[j] ^ seed;
+	}
+	for (sizet j = 0; j < 8; ++j) {
+		acc[j] = s_hash_lane_keys[j] + seed;
+	}
+	_Hash_Lanes lanes(acc);
+	const uint8* const end = p + len;
+	for (; end - p >= static_cast<std::ptrdiff_t>(s_hash_block); p += s_hash_block) {
+		for (sizet s = 0; s < 8; ++s) {
+			lanes.stripe(p + s * s_hash_stripe, keys + s);
+		}
+		lanes.scramble();
+	}
+	for (sizet s = 0; end - p >= static_cast<std::ptrdiff_t>(s_hash_stripe); p += s_hash_stripe, ++s) {
+		lanes.stripe(p, keys + s);
+	}
+	lanes.store(acc);
+	uint64 res = len * s_hash_secret[0];
+	for (sizet j = 0; j < 8; j += 2) {
+		res ^= _Mix(acc[j] ^ s_hash_secret[1], acc[j + 1] ^ s_hash_secret[2]);
+	}
+	return _Hash_Short(p, static_cast<sizet>(end - p), res);
+}
+
+#endif
+
+// Hash len bytes starting at data
+SSTD_INLINE uint64 _Hash_Bytes(const void* data, const sizet& len, const uint64& seed) noexcept {
+	const uint8* p = static_cast<const uint8*>(data);
+#if defined(SSTD_HASH_AVX2)
+	if (len >= s_hash_long) {
+		return _Hash_Long(p, len, seed);
+	}
+#endif
+	return _Hash_Short(p, len, seed);
+}
+
+// -----------------------------------------
+//
+//   Hash functors
+//
+// -----------------------------------------
+
+// Every hasher carries its seed, the default one is _Process_Seed()
+// Two hashers only agree with each other if they have the same seed
+struct _Seeded_Hash {
+	_Seeded_Hash() noexcept : m_seed(_Process_Seed()) {}
+	SSTD_EXPLICIT _Seeded_Hash(const uint64& _seed) noexcept : m_seed(_seed) {}
+
+	SSTD_INLINE SSTD_CONSTEXPR uint64 seed() const noexcept {
+		return m_seed;
+	}
+protected:
+	uint64 m_seed;
+};
+
+// Integers, enums and pointers
+// A single multiply, but sequential keys still end up all over the table
+template<typename T>
+struct _Int_Hash : _Seeded_Hash {
+	using _Seeded_Hash::_Seeded_Hash;
+
+	SSTD_INLINE sizet operator()(const T& key) const noexcept {
+		uint64 bits;
+		if constexpr (std::is_pointer<T>::value) {
+			bits = static_cast<uint64>(reinterpret_cast<std::uintptr_t>(key));
+		}
+		else {
+			bits = static_cast<uint64>(key);
+		}
+		return static_cast<sizet>(_Mix(bits ^ m_seed, 0x9e3779b97f4a7c15ull));
+	}
+};
+
+// 0.0 and -0.0 are equal, so they need the same hash
+template<typename T>
+struct _Float_Hash : _Seeded_Hash {
+	using _Seeded_Hash::_Seeded_Hash;
+
+	SSTD_INLINE sizet operator()(const T& key) const noexcept {
+		const T val = key == T(0) ? T(0) : key;
+		return static_cast<sizet>(_Hash_Bytes(&val, sizeof(T), m_seed));
+	}
+};
+
+// Transparent, so a std::string map can be searched with a std::string_view or const char* directly
+template<typename _CharT>
+struct _String_Hash : _Seeded_Hash {
+	using _Seeded_Hash::_Seeded_Hash;
+	using is_transparent = void;
+
+	SSTD_INLINE sizet operator()(std::basic_string_view<_CharT> key) const noexcept {
+		return static_cast<sizet>(_Hash_Bytes(key.data(), key.size() * sizeof(_CharT), m_seed));
+	}
+};
+
+// Anything else goes through std::hash, which is the identity for a lot of types,
+// so the result gets mixed again
+template<typename T>
+struct _Std_Hash : _Seeded_Hash {
+	using _Seeded_Hash::_Seeded_Hash;
+
+	SSTD_INLINE sizet operator()(const T& key) const {
+		return static_cast<sizet>(_Mix(static_cast<uint64>(std::hash<T>()(key)) ^ m_seed, 0x9e3779b97f4a7c15ull));
+	}
+};
+
+template<typename T>
+using _Pick_Hash = typename std::conditional<std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value,
+	_Int_Hash<T>,
+	typename std::conditional<std::is_floating_point<T>::value,
+		_Float_Hash<T>,
+		_Std_Hash<T>
+	>::type
+>::type;
+
+// The hash every container uses when none is given
+template<typename T>
+struct _Default_Hash : _Pick_Hash<T> {
+	_Default_Hash() SSTD_DEFAULT;
+	SSTD_EXPLICIT _Default_Hash(const uint64& _seed) noexcept : _Pick_Hash<T>(_seed) {}
+};
+template<typename _CharT, typename _Alloc>
+struct _Default_Hash<std::basic_string<_CharT, std::char_traits<_CharT>, _Alloc> > : _String_Hash<_CharT> {
+	using _String_Hash<_CharT>::_String_Hash;
+};
+template<typename _CharT>
+struct _Default_Hash<std::basic_string_view<_CharT> > : _String_Hash<_CharT> {
+	using _String_Hash<_CharT>::_String_Hash;
+};
+
+// The old ( misspelled ) name
+template<typename T>
+using _Deault_Hash = _Default_Hash<T>;
+
+// Seed of any hasher, 0 for a hasher without one
+template<typename _Hash, typename = void>
+struct _Hash_Seed {
+	static SSTD_INLINE SSTD_CONSTEXPR uint64 get(const _Hash&) noexcept {
+		return 0;
+	}
+};
+template<typename _Hash>
+struct _Hash_Seed<_Hash, std::void_t<decltype(std::declval<const _Hash&>().seed())> > {
+	static SSTD_INLINE SSTD_CONSTEXPR uint64 get(const _Hash& hasher) noexcept {
+		return static_cast<uint64>(hasher.seed());
+	}
+};
+
+// A hasher with the given seed, or a default constructed one if it can't take a seed
+template<typename _Hash>
+SSTD_INLINE _Hash _Make_Hash(const uint64& seed) {
+	if constexpr (std::is_constructible<_Hash, const uint64&>::value) {
+		return _Hash(seed);
+	}
+	else {
+		return _Hash();
+	}
+}
+
+SSTD_END
+
+#endif
@@ -0,0 +1,494 @@
+#ifndef SSTD_LRU_CACHE_INCLUDED
+#define SSTD_LRU_CACHE_INCLUDED
+
+#include "core.hpp"
+#include "unordered_map.hpp"
+
+#include <algorithm>
+#include <new>
+#include <utility>
+
+SSTD_BEGIN
+
+// Counters of a cache, since it got built ( or reset_stats )
+struct cache_stats {
+	uint64 hits = 0;
+	uint64 misses = 0;
+	uint64 evictions = 0;
+};
+
+// -----------------------------------------
+//
+//   Cache entries
+//
+// -----------------------------------------
+
+// A fixed array of capacity entries, allocated once
+// The unordered_map of a cache maps a key to the index of its entry, so there's no allocation per entry,
+// and the entries never move ( the slots of the map do, when it rebuilds )
+// Free entries are linked through next, constructed ones are [0, m_used) minus the free list
+// _Entry needs a uint32 next, which is an entry index or s_none while the entry is live
+
+template<typename _Entry>
+class _Cache_Entries {
+public:
+	static SSTD_CONSTEXPR uint32 s_none = ~uint32(0);
+
+	SSTD_EXPLICIT _Cache_Entries(const sizet& capacity) :
+		m_entries(static_cast<_Entry*>(::operator new(sizeof(_Entry) * capacity))), m_capacity(capacity) {
+
+	}
+
+	_Cache_Entries(const _Cache_Entries&) = delete;
+	_Cache_Entries& operator=(const _Cache_Entries&) = delete;
+
+	~_Cache_Entries() {
+		clear();
+		::operator delete(m_entries);
+	}
+
+	SSTD_INLINE _Entry& operator[](const uint32& ind) noexcept {
+		return m_entries[ind];
+	}
+	SSTD_INLINE const _Entry& operator[](const uint32& ind) const noexcept {
+		return m_entries[ind];
+	}
+
+	// Construct a entry from args, s_none if all of them are taken
+	template<typename... _Args>
+	SSTD_INLINE uint32 emplace(_Args&&... args) {
+		uint32 ind = m_free;
+		if (ind != s_none) {
+			m_free = m_entries[ind].next;
+		}
+		else if (m_used < m_capacity) {
+			ind = static_cast<uint32>(m_used++);
+		}
+		else {
+			return s_none;
+		}
+		new (m_entries + ind) _Entry{ std::forward<_Args>(args)... };
+		return ind;
+	}
+
+	SSTD_INLINE void destroy(const uint32& ind) noexcept {
+		m_entries[ind].~_Entry();
+		// The entry is only raw memory from here on, next is written over it
+		new (&m_entries[ind].next) uint32(m_free);
+		m_free = ind;
+	}
+
+	// next of a live entry is another index or s_none, never s_freed, so marking the free ones through next needs no memory
+	SSTD_INLINE void clear() noexcept {
+		for (uint32 ind = m_free; ind != s_none;) {
+			const uint32 next = m_entries[ind].next;
+			m_entries[ind].next = s_freed;
+			ind = next;
+		}
+		for (sizet i = 0; i < m_used; ++i) {
+			if (m_entries[i].next != s_freed) {
+				m_entries[i].~_Entry();
+			}
+		}
+		m_used = 0;
+		m_free = s_none;
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR sizet capacity() const noexcept {
+		return m_capacity;
+	}
+private:
+	static SSTD_CONSTEXPR uint32 s_freed = s_none - 1;
+
+	_Entry* m_entries = nullptr;
+	sizet m_capacity = 0;
+	sizet m_used = 0;
+	uint32 m_free = s_none;
+};
+
+// -----------------------------------------
+//
+//   Cache map
+//
+// -----------------------------------------
+
+// The map of a cache gets all of its slots up front and never grows:
+// room for capacity + 1 keys ( put inserts the new key before it evicts ) and capacity / 4 Deleted slots under the 0.5 max_load_factor,
+// and once the Deleted slots left by evictions take up that room, make_room rebuilds the table at the same capacity
+// ( With Robin Hood probing there are no Deleted slots to begin with )
+
+template<typename _Map>
+struct _Cache_Map {
+	// Slots of the map of a cache of capacity entries, never below the 8 a new map starts with
+	static SSTD_INLINE SSTD_CONSTEXPR sizet slots(const sizet& capacity) noexcept {
+		const sizet wanted = 2 * (capacity + capacity / 4 + 2);
+		return _Map::slot_capacity(wanted > 8 ? wanted : 8);
+	}
+
+	// Bytes of a cache of capacity entries, give or take the padding of the control bytes
+	static SSTD_INLINE SSTD_CONSTEXPR sizet bytes(const sizet& capacity, const sizet& entry_bytes) noexcept {
+		return capacity * entry_bytes + slots(capacity) * _Map::slot_bytes();
+	}
+
+	// Largest capacity that fits into _bytes
+	static SSTD_INLINE SSTD_CONSTEXPR sizet capacity_for(const sizet& _bytes, const sizet& entry_bytes) noexcept {
+		// bytes(low) fits, bytes(high) doesn't
+		sizet low = 0, high = _bytes / entry_bytes + 1;
+		while (high - low > 1) {
+			const sizet mid = low + (high - low) / 2;
+			(bytes(mid, entry_bytes) <= _bytes ? low : high) = mid;
+		}
+		return low;
+	}
+
+	// reserve adds to the capacity, ask for what's missing
+	static SSTD_INLINE void reserve(_Map& map, const sizet& capacity) {
+		map.reserve(slots(capacity) - map.capacity());
+	}
+
+	// Call before every insert, while the map holds at most capacity keys
+	static SSTD_INLINE void make_room(_Map& map) {
+		if (static_cast<Decimal>(map.size() + map.tombstones() + 1) > map.capacity() * map.max_load_factor()) {
+			// Rebuild at the same capacity, which drops the Deleted slots
+			map.reserve(0);
+		}
+	}
+};
+
+// -----------------------------------------
+//
+//   LRU cache
+//
+// -----------------------------------------
+
+// Keeps the capacity most recently used keys, put evicts the least recently used one once it's full
+// The recency list is threaded through the entry array by index ( 2 x uint32 per entry ), so get / put / evict are O(1)
+// and the whole cache is 2 allocations, no matter how many entries it has
+
+template<
+	typename _KeyT,	// Key type
+	typename _EltT,		// Element type
+	typename _Hash = _Default_Hash<_KeyT>, // Hash function
+	typename _ProbT = _Double_Hash_Prob<_KeyT, _Hash> // probing function
+>
+class lru_cache {
+	struct _Entry {
+		_KeyT key;
+		_EltT elt;
+		// Towards the most / least recently used end
+		uint32 prev;
+		uint32 next;
+	};
+	using _Entries = _Cache_Entries<_Entry>;
+	static SSTD_CONSTEXPR uint32 s_none = _Entries::s_none;
+public:
+	using map_type = unordered_map<_KeyT, uint32, _Hash, _ProbT>;
+private:
+	using _Map = _Cache_Map<map_type>;
+public:
+
+	SSTD_EXPLICIT lru_cache(const sizet& capacity) :
+		m_entries(capacity ? capacity : 1) {
+		// Room for every entry up front, the map never has to grow
+		_Map::reserve(m_map, m_entries.capacity());
+	}
+
+	lru_cache(const lru_cache&) = delete;
+	lru_cache& operator=(const lru_cache&) = delete;
+
+	// As many entries as fit into bytes, counting both the entries and the map slots
+	static SSTD_INLINE SSTD_CONSTEXPR sizet capacity_for(const sizet& bytes) noexcept {
+		return _Map::capacity_for(bytes, sizeof(_Entry));
+	}
+
+	// The element of key, or nullptr if it isn't cached
+	// A hit makes key the most recently used one
+	SSTD_INLINE _EltT* get(const _KeyT& key) {
+		const typename map_type::iterator itr = m_map.find(key);
+		if (itr == m_map.end()) {
+			++m_stats.misses;
+			return nullptr;
+		}
+		++m_stats.hits;
+		const uint32 ind = itr->second;
+		_Unlink(ind);
+		_Push_Front(ind);
+		return &m_entries[ind].elt;
+	}
+
+	// Same as get, but doesn't count or touch the recency
+	SSTD_INLINE const _EltT* peek(const _KeyT& key) const {
+		const typename map_type::const_iterator itr = m_map.find(key);
+		return itr == m_map.end() ? nullptr : &m_entries[itr->second].elt;
+	}
+
+	SSTD_INLINE bool contains(const _KeyT& key) const {
+		return m_map.contains(key);
+	}
+
+	// Insert, or overwrite the element if the key is already cached, either way key becomes the most recently used one
+	// Evicts the least recently used key if the cache is full
+	template<typename _M>
+	SSTD_INLINE void put(const _KeyT& key, _M&& elt) {
+		_Map::make_room(m_map);
+		const std::pair<typename map_type::iterator, bool> res = m_map.try_emplace(key, s_none);
+		if (!res.second) {
+			const uint32 ind = res.first->second;
+			m_entries[ind].elt = std::forward<_M>(elt);
+			_Unlink(ind);
+			_Push_Front(ind);
+			return;
+		}
+		uint32 ind = m_entries.emplace(key, std::forward<_M>(elt), s_none, s_none);
+		if (ind == s_none) {
+			// Full, the least recently used entry gets the new key
+			ind = m_tail;
+			++m_stats.evictions;
+			_Unlink(ind);
+			m_map.erase(m_entries[ind].key);
+			m_entries[ind].key = key;
+			m_entries[ind].elt = std::forward<_M>(elt);
+			// The erase might have moved the new key's slot
+			m_map.find(key)->second = ind;
+		}
+		else {
+			res.first->second = ind;
+			++m_size;
+		}
+		_Push_Front(ind);
+	}
+
+	// Returns false if key wasn't cached
+	SSTD_INLINE bool erase(const _KeyT& key) {
+		const typename map_type::iterator itr = m_map.find(key);
+		if (itr == m_map.end()) {
+			return false;
+		}
+		const uint32 ind = itr->second;
+		m_map.erase(key);
+		_Unlink(ind);
+		m_entries.destroy(ind);
+		--m_size;
+		return true;
+	}
+
+	SSTD_INLINE void clear() {
+		m_entries.clear();
+		m_map.clear();
+		_Map::reserve(m_map, m_entries.capacity());
+		m_head = m_tail = s_none;
+		m_size = 0;
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR sizet size() const noexcept {
+		return m_size;
+	}
+	SSTD_INLINE SSTD_CONSTEXPR sizet capacity() const noexcept {
+		return m_entries.capacity();
+	}
+	SSTD_INLINE SSTD_CONSTEXPR bool empty() const noexcept {
+		return m_size == 0;
+	}
+
+	SSTD_INLINE const cache_stats& stats() const noexcept {
+		return m_stats;
+	}
+	SSTD_INLINE void reset_stats() noexcept {
+		m_stats = cache_stats();
+	}
+
+	// Call func(key, element) from the most to the least recently used key
+	template<typename _Func>
+	SSTD_INLINE void for_each(_Func&& func) const {
+		for (uint32 ind = m_head; ind != s_none; ind = m_entries[ind].next) {
+			func(static_cast<const _KeyT&>(m_entries[ind].key), static_cast<const _EltT&>(m_entries[ind].elt));
+		}
+	}
+private:
+	_Entries m_entries;
+	map_type m_map;
+	// Most / least recently used entry
+	uint32 m_head = s_none;
+	uint32 m_tail = s_none;
+	sizet m_size = 0;
+	cache_stats m_stats;
+
+	SSTD_INLINE void _Unlink(const uint32& ind) noexcept {
+		_Entry& entry = m_entries[ind];
+		(entry.prev != s_none ? m_entries[entry.prev].next : m_head) = entry.next;
+		(entry.next != s_none ? m_entries[entry.next].prev : m_tail) = entry.prev;
+	}
+
+	SSTD_INLINE void _Push_Front(const uint32& ind) noexcept {
+		_Entry& entry = m_entries[ind];
+		entry.prev = s_none;
+		entry.next = m_head;
+		(m_head != s_none ? m_entries[m_head].prev : m_tail) = ind;
+		m_head = ind;
+	}
+};
+
+// -----------------------------------------
+//
+//   CLOCK cache
+//
+// -----------------------------------------
+
+// lru_cache without the list: a hit only sets the referenced bit of its entry, nothing is unlinked or relinked
+// To evict, a hand sweeps over the entries, clearing referenced bits, and takes the first one that wasn't referenced
+// since the last sweep ( a second chance ), which gets close to LRU for a lot less work per hit
+
+template<
+	typename _KeyT,	// Key type
+	typename _EltT,		// Element type
+	typename _Hash = _Default_Hash<_KeyT>, // Hash function
+	typename _ProbT = _Double_Hash_Prob<_KeyT, _Hash> // probing function
+>
+class clock_cache {
+	struct _Entry {
+		_KeyT key;
+		_EltT elt;
+		uint32 next; // free list only
+	};
+	using _Entries = _Cache_Entries<_Entry>;
+	static SSTD_CONSTEXPR uint32 s_none = _Entries::s_none;
+public:
+	using map_type = unordered_map<_KeyT, uint32, _Hash, _ProbT>;
+private:
+	using _Map = _Cache_Map<map_type>;
+public:
+
+	SSTD_EXPLICIT clock_cache(const sizet& capacity) :
+		m_entries(capacity ? capacity : 1), m_referenced(new uint8[m_entries.capacity()]()) {
+		_Map::reserve(m_map, m_entries.capacity());
+	}
+
+	clock_cache(const clock_cache&) = delete;
+	clock_cache& operator=(const clock_cache&) = delete;
+
+	~clock_cache() {
+		delete[] m_referenced;
+	}
+
+	// As many entries as fit into bytes, counting both the entries and the map slots
+	static SSTD_INLINE SSTD_CONSTEXPR sizet capacity_for(const sizet& bytes) noexcept {
+		// + the referenced byte
+		return _Map::capacity_for(bytes, sizeof(_Entry) + 1);
+	}
+
+	// The element of key, or nullptr if it isn't cached
+	SSTD_INLINE _EltT* get(const _KeyT& key) {
+		const typename map_type::iterator itr = m_map.find(key);
+		if (itr == m_map.end()) {
+			++m_stats.misses;
+			return nullptr;
+		}
+		++m_stats.hits;
+		m_referenced[itr->second] = 1;
+		return &m_entries[itr->second].elt;
+	}
+
+	// Same as get, but doesn't count or set the referenced bit
+	SSTD_INLINE const _EltT* peek(const _KeyT& key) const {
+		const typename map_type::const_iterator itr = m_map.find(key);
+		return itr == m_map.end() ? nullptr : &m_entries[itr->second].elt;
+	}
+
+	SSTD_INLINE bool contains(const _KeyT& key) const {
+		return m_map.contains(key);
+	}
+
+	// Insert, or overwrite the element if the key is already cached
+	// Evicts a key that wasn't used since the hand last passed it if the cache is full
+	template<typename _M>
+	SSTD_INLINE void put(const _KeyT& key, _M&& elt) {
+		_Map::make_room(m_map);
+		const std::pair<typename map_type::iterator, bool> res = m_map.try_emplace(key, s_none);
+		if (!res.second) {
+			const uint32 ind = res.first->second;
+			m_entries[ind].elt = std::forward<_M>(elt);
+			m_referenced[ind] = 1;
+			return;
+		}
+		uint32 ind = m_entries.emplace(key, std::forward<_M>(elt), s_none);
+		if (ind == s_none) {
+			ind = _Victim();
+			++m_stats.evictions;
+			m_map.erase(m_entries[ind].key);
+			m_entries[ind].key = key;
+			m_entries[ind].elt = std::forward<_M>(elt);
+			// The erase might have moved the new key's slot
+			m_map.find(key)->second = ind;
+		}
+		else {
+			res.first->second = ind;
+			++m_size;
+		}
+		// New keys start unreferenced, a key that's never read again goes first
+		m_referenced[ind] = 0;
+	}
+
+	// Returns false if key wasn't cached
+	SSTD_INLINE bool erase(const _KeyT& key) {
+		const typename map_type::iterator itr = m_map.find(key);
+		if (itr == m_map.end()) {
+			return false;
+		}
+		const uint32 ind = itr->second;
+		m_map.erase(key);
+		m_entries.destroy(ind);
+		m_referenced[ind] = 0;
+		--m_size;
+		return true;
+	}
+
+	SSTD_INLINE void clear() {
+		m_entries.clear();
+		m_map.clear();
+		_Map::reserve(m_map, m_entries.capacity());
+		std::fill(m_referenced, m_referenced + m_entries.capacity(), uint8(0));
+		m_hand = 0;
+		m_size = 0;
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR sizet size() const noexcept {
+		return m_size;
+	}
+	SSTD_INLINE SSTD_CONSTEXPR sizet capacity() const noexcept {
+		return m_entries.capacity();
+	}
+	SSTD_INLINE SSTD_CONSTEXPR bool empty() const noexcept {
+		return m_size == 0;
+	}
+
+	SSTD_INLINE const cache_stats& stats() const noexcept {
+		return m_stats;
+	}
+	SSTD_INLINE void reset_stats() noexcept {
+		m_stats = cache_stats();
+	}
+private:
+	_Entries m_entries;
+	map_type m_map;
+	// One byte per entry, apart from the entries so a sweep reads as few lines as possible
+	uint8* m_referenced = nullptr;
+	sizet m_hand = 0;
+	sizet m_size = 0;
+	cache_stats m_stats;
+
+	// Only called when every entry is taken, so all of them are live
+	// Ends within 2 rounds, the first one clears every referenced bit it passes
+	SSTD_INLINE uint32 _Victim() noexcept {
+		while (m_referenced[m_hand]) {
+			m_referenced[m_hand] = 0;
+			m_hand = m_hand + 1 == m_entries.capacity() ? 0 : m_hand + 1;
+		}
+		const uint32 ind = static_cast<uint32>(m_hand);
+		m_hand = m_hand + 1 == m_entries.capacity() ? 0 : m_hand + 1;
+		return ind;
+	}
+};
+
+SSTD_END
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef SSTD_MAPPED_FILE_INCLUDED
+#define SSTD_MAPPED_FILE_INCLUDED
+
+#include "core.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+SSTD_BEGIN
+
+// A whole file mapped read only
+// Nothing is read up front, the OS pages the file in as it gets touched
+// Throws std::runtime_error if the file can't be opened or mapped
+
+class _Mapped_File {
+public:
+	_Mapped_File() noexcept SSTD_DEFAULT;
+
+	SSTD_EXPLICIT _Mapped_File(const char* path) {
+#if defined(_WIN32)
+		HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			throw std::runtime_error(std::string("Can't open ") + path);
+		}
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+			CloseHandle(file);
+			throw std::runtime_error(std::string("Can't map an empty file ") + path);
+		}
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		if (mapping == nullptr) {
+			throw std::runtime_error(std::string("Can't map ") + path);
+		}
+		// The view keeps the mapping alive on its own
+		void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+		if (data == nullptr) {
+			throw std::runtime_error(std::string("Can't map ") + path);
+		}
+		m_data = static_cast<const uint8*>(data);
+		m_size = static_cast<sizet>(size.QuadPart);
+#else
+		const int fd = ::open(path, O_RDONLY);
+		if (fd < 0) {
+			throw std::runtime_error(std::string("Can't open ") + path);
+		}
+		struct stat info;
+		if (::fstat(fd, &info) != 0 || info.st_size == 0) {
+			::close(fd);
+			throw std::runtime_error(std::string("Can't map an empty file ") + path);
+		}
+		// The mapping keeps the file alive on its own
+		void* data = ::mmap(nullptr, static_cast<sizet>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+		::close(fd);
+		if (data == MAP_FAILED) {
+			throw std::runtime_error(std::string("Can't map ") + path);
+		}
+		m_data = static_cast<const uint8*>(data);
+		m_size = static_cast<sizet>(info.st_size);
+#endif
+	}
+
+	_Mapped_File(const _Mapped_File&) = delete;
+	_Mapped_File& operator=(const _Mapped_File&) = delete;
+
+	_Mapped_File(_Mapped_File&& other) noexcept :
+		m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)) {
+
+	}
+	_Mapped_File& operator=(_Mapped_File&& other) noexcept {
+		if (this != &other) {
+			_Unmap();
+			m_data = std::exchange(other.m_data, nullptr);
+			m_size = std::exchange(other.m_size, 0);
+		}
+		return *this;
+	}
+
+	~_Mapped_File() {
+		_Unmap();
+	}
+
+	SSTD_INLINE const uint8* data() const noexcept {
+		return m_data;
+	}
+	SSTD_INLINE sizet size() const noexcept {
+		return m_size;
+	}
+private:
+	const uint8* m_data = nullptr;
+	sizet m_size = 0;
+
+	SSTD_INLINE void _Unmap() noexcept {
+		if (m_data == nullptr) {
+			return;
+		}
+#if defined(_WIN32)
+		UnmapViewOfFile(m_data);
+#else
+		::munmap(const_cast<uint8*>(m_data), m_size);
+#endif
+		m_data = nullptr;
+		m_size = 0;
+	}
+};
+
+SSTD_END
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef SSTD_MAPPED_UNORDERED_MAP_INCLUDED
+#define SSTD_MAPPED_UNORDERED_MAP_INCLUDED
+
+#include "core.hpp"
+#include "unordered_map.hpp"
+#include "mapped_file.hpp"
+
+#include <type_traits>
+#include <utility>
+
+SSTD_BEGIN
+
+// -----------------------------------------
+//
+//   Mapped table
+//
+// -----------------------------------------
+
+// A read only unordered_map over a file written by unordered_map::save ( see unordered_map::open_mapped )
+// The lookups run the same code as a normal map, only the slots live in the mapped file
+// The hasher gets the seed the table was built with, not the one of this process
+
+template<
+	typename _KeyT,
+	typename _EltT,
+	typename _Hash,
+	typename _ProbT
+>
+class mapped_unordered_map {
+public:
+	using map_type = unordered_map<_KeyT, _EltT, _Hash, _ProbT>;
+	using const_iterator = typename map_type::const_iterator;
+
+	SSTD_EXPLICIT mapped_unordered_map(const char* path) :
+		m_file(path) {
+		_Hash hasher;
+		sizet _size = 0;
+		const typename map_type::_Table tab = map_type::_Open_Image(m_file.data(), m_file.size(), hasher, _size);
+		m_map = new map_type(hasher, tab, _size);
+	}
+
+	mapped_unordered_map(const mapped_unordered_map&) = delete;
+	mapped_unordered_map& operator=(const mapped_unordered_map&) = delete;
+
+	mapped_unordered_map(mapped_unordered_map&& other) noexcept :
+		m_file(std::move(other.m_file)), m_map(std::exchange(other.m_map, nullptr)) {
+
+	}
+	mapped_unordered_map& operator=(mapped_unordered_map&& other) noexcept {
+		if (this != &other) {
+			_Close();
+			m_file = std::move(other.m_file);
+			m_map = std::exchange(other.m_map, nullptr);
+		}
+		return *this;
+	}
+
+	~mapped_unordered_map() {
+		_Close();
+	}
+
+	SSTD_INLINE const_iterator find(const _KeyT& key) const {
+		return _Map().find(key);
+	}
+	template<typename _K, typename _H = _Hash, typename = typename std::enable_if<_Is_Transparent<_H>::value>::type>
+	SSTD_INLINE const_iterator find(const _K& key) const {
+		return _Map().find(key);
+	}
+
+	SSTD_INLINE bool contains(const _KeyT& key) const {
+		return _Map().contains(key);
+	}
+	template<typename _K, typename _H = _Hash, typename = typename std::enable_if<_Is_Transparent<_H>::value>::type>
+	SSTD_INLINE bool contains(const _K& key) const {
+		return _Map().contains(key);
+	}
+
+	// Same as unordered_map::find_batch, the prefetching pulls the mapped pages in ahead of the lookups too
+	SSTD_INLINE sizet find_batch(const _KeyT* keys, const sizet& n, const _EltT** out) const {
+		return _Map().find_batch(keys, n, out);
+	}
+
+	SSTD_INLINE sizet size() const noexcept {
+		return _Map().size();
+	}
+	SSTD_INLINE sizet capacity() const noexcept {
+		return _Map().capacity();
+	}
+	SSTD_INLINE bool empty() const noexcept {
+		return _Map().empty();
+	}
+
+	SSTD_INLINE const_iterator begin() const noexcept {
+		return _Map().begin();
+	}
+	SSTD_INLINE const_iterator end() const noexcept {
+		return _Map().end();
+	}
+	SSTD_INLINE const_iterator cbegin() const noexcept {
+		return begin();
+	}
+	SSTD_INLINE const_iterator cend() const noexcept {
+		return end();
+	}
+private:
+	_Mapped_File m_file;
+	// Only ever used through a const reference, the table points into m_file
+	map_type* m_map = nullptr;
+
+	SSTD_INLINE const map_type& _Map() const noexcept {
+		return *m_map;
+	}
+
+	// The table belongs to the file, the map must not free it
+	SSTD_INLINE void _Close() noexcept {
+		if (m_map != nullptr) {
+			m_map->m_table = typename map_type::_Table();
+			delete m_map;
+			m_map = nullptr;
+		}
+	}
+};
+
+template<
+	typename _KeyT,
+	typename _EltT,
+	typename _Hash,
+	typename _ProbT
+>
+SSTD_INLINE mapped_unordered_map<_KeyT, _EltT, _Hash, _ProbT> unordered_map<_KeyT, _EltT, _Hash, _ProbT>::open_mapped(const char* path) {
+	return mapped_unordered_map<_KeyT, _EltT, _Hash, _ProbT>(path);
+}
+
+SSTD_END
+
+#endif
@@ -0,0 +1,335 @@
+#ifndef SSTD_PARALLEL_AGGREGATE_INCLUDED
+#define SSTD_PARALLEL_AGGREGATE_INCLUDED
+
+#include "core.hpp"
+#include "unordered_map.hpp"
+
+#include <atomic>
+#include <exception>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+SSTD_BEGIN
+
+// -----------------------------------------
+//
+//   Partitioned map
+//
+// -----------------------------------------
+
+// A group-by result, split into _Count independent unordered_maps by the hash of the key
+// Every key lives in exactly one partition, so each partition can be read ( or handed to a thread ) on its own
+
+template<
+	typename _KeyT,	// Key type
+	typename _AggT,		// Aggregate type
+	typename _Hash = _Default_Hash<_KeyT>, // Hash function
+	typename _ProbT = _Double_Hash_Prob<_KeyT, _Hash> // probing function
+>
+class partitioned_unordered_map {
+	// Builds the partitions itself, and hands them over with _Adopt
+	template<
+		typename _A, typename _H1, typename _P1, typename _Iter, typename _KeyFn, typename _CombineFn, typename _MergeFn,
+		typename _K, typename _H2, typename _P2
+	>
+	friend partitioned_unordered_map<_K, _A, _H2, _P2> parallel_aggregate(_Iter, _Iter, _KeyFn, _CombineFn, _MergeFn, sizet);
+public:
+	using map_type = unordered_map<_KeyT, _AggT, _Hash, _ProbT>;
+
+	// count needs to be a power of 2
+	SSTD_EXPLICIT partitioned_unordered_map(const sizet& count) :
+		m_parts(new map_type*[count]), m_count(count) {
+		SSTD_ASSERT(count > 0 && (count & (count - 1)) == 0);
+		for (sizet i = 0; i < m_count; ++i) {
+			m_parts[i] = nullptr;
+		}
+	}
+
+	partitioned_unordered_map(const partitioned_unordered_map&) = delete;
+	partitioned_unordered_map& operator=(const partitioned_unordered_map&) = delete;
+
+	partitioned_unordered_map(partitioned_unordered_map&& other) noexcept :
+		m_parts(std::exchange(other.m_parts, nullptr)), m_count(std::exchange(other.m_count, 0)), m_Hasher(other.m_Hasher) {
+
+	}
+	partitioned_unordered_map& operator=(partitioned_unordered_map&& other) noexcept {
+		if (this != &other) {
+			_Free();
+			m_parts = std::exchange(other.m_parts, nullptr);
+			m_count = std::exchange(other.m_count, 0);
+			m_Hasher = other.m_Hasher;
+		}
+		return *this;
+	}
+
+	~partitioned_unordered_map() {
+		_Free();
+	}
+
+	// Copy the aggregate out, returns false if the key doesn't exist
+	SSTD_INLINE bool find(const _KeyT& key, _AggT& out) const {
+		const map_type& part = partition(partition_of(key));
+		typename map_type::const_iterator itr = part.find(key);
+		if (itr == part.end()) {
+			return false;
+		}
+		out = itr->second;
+		return true;
+	}
+
+	SSTD_INLINE bool contains(const _KeyT& key) const {
+		return partition(partition_of(key)).contains(key);
+	}
+
+	// Call func(key, aggregate) for every key, one partition after another
+	template<typename _Func>
+	SSTD_INLINE void for_each(_Func&& func) const {
+		for (sizet i = 0; i < m_count; ++i) {
+			const map_type& part = partition(i);
+			for (typename map_type::const_iterator itr = part.begin(); itr != part.end(); ++itr) {
+				func(itr->first, itr->second);
+			}
+		}
+	}
+
+	// Insert every key into out, for when one map is needed after all
+	SSTD_INLINE void collect(map_type& out) const {
+		out.reserve(size() * 2);
+		for_each([&](const _KeyT& key, const _AggT& agg) {
+			out.insert(key, agg);
+		});
+	}
+
+	SSTD_INLINE sizet size() const noexcept {
+		sizet res = 0;
+		for (sizet i = 0; i < m_count; ++i) {
+			res += m_parts[i] ? m_parts[i]->size() : 0;
+		}
+		return res;
+	}
+	SSTD_INLINE bool empty() const noexcept {
+		return size() == 0;
+	}
+
+	// The partition key belongs to
+	SSTD_INLINE sizet partition_of(const _KeyT& key) const {
+		return _Partition_Of(m_Hasher(key), m_count);
+	}
+	// Builds the partition if nothing went into it yet, i needs to be below partition_count()
+	SSTD_INLINE map_type& partition(const sizet& i) {
+		SSTD_ASSERT(i < m_count);
+		if (m_parts[i] == nullptr) {
+			m_parts[i] = new map_type();
+		}
+		return *m_parts[i];
+	}
+	// Never allocates, a partition nothing went into yet ( or one of a moved-from map ) reads as empty
+	SSTD_INLINE const map_type& partition(const sizet& i) const {
+		return i < m_count && m_parts[i] != nullptr ? *m_parts[i] : _Empty();
+	}
+	SSTD_INLINE sizet partition_count() const noexcept {
+		return m_count;
+	}
+private:
+	map_type** m_parts = nullptr;
+	sizet m_count = 0;
+
+	_Hash m_Hasher{};
+
+	// Partition of a hash, out of count ( a power of 2, or 0 once moved from )
+	// The maps themselves read the low bits ( _Mask_Reduce ), the high bits ( _Fastrange_Reduce ) and the top 7 bits ( _Ctrl ),
+	// so the partition comes from a multiply of the whole hash instead, the keys of one partition still spread over its table
+	static SSTD_INLINE sizet _Partition_Of(const sizet& hash, const sizet& count) noexcept {
+		if (count <= 1) {
+			return 0;
+		}
+		return static_cast<sizet>((static_cast<uint64>(hash) * 0x9e3779b97f4a7c15ull) >> (64 - _Bits(count)));
+	}
+
+	// Hand the map over as partition i, the partition takes ownership
+	SSTD_INLINE void _Adopt(const sizet& i, map_type* map) noexcept {
+		delete m_parts[i];
+		m_parts[i] = map;
+	}
+
+	static SSTD_INLINE const map_type& _Empty() {
+		static const map_type s_empty;
+		return s_empty;
+	}
+
+	static SSTD_INLINE SSTD_CONSTEXPR uint32 _Bits(const sizet& count) noexcept {
+		uint32 bits = 0;
+		while ((sizet(1) << bits) < count) {
+			++bits;
+		}
+		return bits;
+	}
+
+	SSTD_INLINE void _Free() noexcept {
+		for (sizet i = 0; i < m_count; ++i) {
+			delete m_parts[i];
+		}
+		delete[] m_parts;
+		m_parts = nullptr;
+		m_count = 0;
+	}
+};
+
+// -----------------------------------------
+//
+//   Parallel aggregate
+//
+// -----------------------------------------
+
+// Fewer rows than this aren't worth starting a thread for
+SSTD_CONSTEXPR sizet s_aggregate_min_rows = 4096;
+
+// Group the rows of [first, last) by key_fn(row) on threads threads
+//
+//   combine_fn(agg, row)    : fold a row into the aggregate of its key ( a new key starts from _AggT() )
+//   merge_fn(agg, other)    : fold the aggregate another thread built for the same key into agg
+//
+// Two passes, neither of them takes a lock:
+//   1. Every thread takes a slice of the rows and aggregates it into its own maps, one per partition
+//   2. Every partition is claimed by one thread, which merges what all the threads built for it
+// There are a few partitions per thread, so one partition full of heavy keys doesn't hold up the rest
+// threads is capped at the core count, and at one thread per s_aggregate_min_rows rows
+//
+// The iterators need to be random access, an exception thrown by combine_fn / merge_fn comes out of here after all threads stopped
+
+template<
+	typename _AggT,
+	typename _Hash = void,
+	typename _ProbT = void,
+	typename _Iter,
+	typename _KeyFn,
+	typename _CombineFn,
+	typename _MergeFn,
+	typename _KeyT = typename std::decay<decltype(std::declval<_KeyFn&>()(*std::declval<_Iter&>()))>::type,
+	typename _H = typename std::conditional<std::is_void<_Hash>::value, _Default_Hash<_KeyT>, _Hash>::type,
+	typename _P = typename std::conditional<std::is_void<_ProbT>::value, _Double_Hash_Prob<_KeyT, _H>, _ProbT>::type
+>
+SSTD_INLINE partitioned_unordered_map<_KeyT, _AggT, _H, _P> parallel_aggregate(
+	_Iter first, _Iter last, _KeyFn key_fn, _CombineFn combine_fn, _MergeFn merge_fn,
+	sizet threads = std::thread::hardware_concurrency()
+) {
+	using _Result = partitioned_unordered_map<_KeyT, _AggT, _H, _P>;
+	using _Map = typename _Result::map_type;
+	SSTD_STATIC_ASSERT(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_Iter>::iterator_category>::value,
+		"parallel_aggregate needs random access iterators");
+
+	const sizet rows = static_cast<sizet>(last - first);
+	// More threads than cores only take turns, and every thread costs a map per partition
+	const sizet cores = std::thread::hardware_concurrency();
+	const sizet max_threads = rows / s_aggregate_min_rows ? rows / s_aggregate_min_rows : 1;
+	threads = threads ? threads : 1;
+	threads = cores && threads > cores ? cores : threads;
+	threads = threads < max_threads ? threads : max_threads;
+	sizet parts = 1;
+	while (parts < threads * 4) {
+		parts <<= 1;
+	}
+	if (threads == 1) {
+		parts = 1;
+	}
+
+	_Result res(parts);
+	const _H hasher{};
+	// local[t * parts + p] : what thread t aggregated for partition p ( nullptr until a row of p shows up )
+	std::vector<_Map*> local(threads * parts, nullptr);
+	std::vector<std::exception_ptr> errors(threads);
+
+	auto run = [&](auto&& work) {
+		std::vector<std::thread> pool;
+		pool.reserve(threads - 1);
+		for (sizet t = 1; t < threads; ++t) {
+			pool.emplace_back([&, t]() {
+				try {
+					work(t);
+				}
+				catch (...) {
+					errors[t] = std::current_exception();
+				}
+			});
+		}
+		try {
+			work(0);
+		}
+		catch (...) {
+			errors[0] = std::current_exception();
+		}
+		for (std::thread& thread : pool) {
+			thread.join();
+		}
+	};
+	auto rethrow = [&]() {
+		for (const std::exception_ptr& error : errors) {
+			if (error) {
+				for (_Map* map : local) {
+					delete map;
+				}
+				std::rethrow_exception(error);
+			}
+		}
+	};
+
+	// 1. Aggregate every slice locally
+	run([&](const sizet t) {
+		_Map** maps = local.data() + t * parts;
+		const _Iter begin = first + static_cast<std::ptrdiff_t>(rows * t / threads);
+		const _Iter end = first + static_cast<std::ptrdiff_t>(rows * (t + 1) / threads);
+		for (_Iter itr = begin; itr != end; ++itr) {
+			const _KeyT key = key_fn(*itr);
+			_Map*& map = maps[_Result::_Partition_Of(hasher(key), parts)];
+			if (map == nullptr) {
+				map = new _Map();
+			}
+			combine_fn((*map)[key], *itr);
+		}
+	});
+	rethrow();
+
+	// 2. Merge every partition into the largest local map of it
+	std::atomic<sizet> next_part{ 0 };
+	run([&](const sizet) {
+		for (sizet p = next_part++; p < parts; p = next_part++) {
+			sizet largest = threads;
+			for (sizet t = 0; t < threads; ++t) {
+				const _Map* map = local[t * parts + p];
+				if (map != nullptr && (largest == threads || map->size() > local[largest * parts + p]->size())) {
+					largest = t;
+				}
+			}
+			if (largest == threads) {
+				// No row went into p, it stays empty
+				continue;
+			}
+			_Map* into = local[largest * parts + p];
+			for (sizet t = 0; t < threads; ++t) {
+				_Map*& from = local[t * parts + p];
+				if (t == largest || from == nullptr) {
+					continue;
+				}
+				for (typename _Map::iterator itr = from->begin(); itr != from->end(); ++itr) {
+					const std::pair<typename _Map::iterator, bool> res = into->try_emplace(itr->first, itr->second);
+					if (!res.second) {
+						merge_fn(res.first->second, itr->second);
+					}
+				}
+				delete from;
+				from = nullptr;
+			}
+			local[largest * parts + p] = nullptr;
+			res._Adopt(p, into);
+		}
+	});
+	rethrow();
+	return res;
+}
+
+SSTD_END
+
+#endif
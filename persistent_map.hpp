@@ -0,0 +1,723 @@
+#ifndef SSTD_PERSISTENT_MAP_INCLUDED
+#define SSTD_PERSISTENT_MAP_INCLUDED
+
+#include "core.hpp"
+#include "hash.hpp"
+#include "Iterator.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <utility>
+
+SSTD_BEGIN
+
+// -----------------------------------------
+//
+//   Hash array mapped trie
+//
+// -----------------------------------------
+
+// The trie under persistent_map and transient_map
+//
+// Every node takes 5 bits of the hash, and keeps 2 bitmaps of those 32 possible branches:
+// datamap for the branches that end in a entry right here, nodemap for the ones that go on into a child node
+// Both are stored compactly, the entry of a branch is at popcount( datamap below its bit ), same for the children
+// Past the last bits of the hash, keys with the exact same hash share a collision node, a plain array of entries
+//
+// Nodes are reference counted and never changed once shared:
+// an update copies the nodes on the path to the key ( path copying ) and points the copies at all the old children,
+// so every version shares everything but that path with the one it came from
+// A node only referenced once, on a path only referenced once, is changed in place instead ( transients )
+
+template<typename _KeyT, typename _EltT>
+struct _Hamt {
+	struct _Entry {
+		sizet hash;
+		_KeyT key;
+		_EltT elt;
+	};
+	// The entries and the children are allocated right after the header
+	struct _Node {
+		std::atomic<uint32> refs;
+		uint32 datamap;
+		uint32 nodemap;
+		// Number of entries
+		uint32 count;
+	};
+
+	static SSTD_CONSTEXPR uint32 s_bits = 5;
+	// Shifts at or past this are collision nodes
+	static SSTD_CONSTEXPR uint32 s_hash_bits = sizeof(sizet) * 8;
+	// Levels down to a collision node, for the iterator stack
+	static SSTD_CONSTEXPR uint32 s_max_depth = (s_hash_bits + s_bits - 1) / s_bits + 1;
+	static SSTD_CONSTEXPR uint32 s_none = ~uint32(0);
+
+	SSTD_STATIC_ASSERT(alignof(_Entry) <= alignof(std::max_align_t), "persistent_map doesn't support over aligned keys / elements");
+
+	static SSTD_CONSTEXPR sizet s_entries_offset = (sizeof(_Node) + alignof(_Entry) - 1) / alignof(_Entry) * alignof(_Entry);
+
+	static SSTD_INLINE sizet _Children_Offset(const uint32& count) noexcept {
+		const sizet end = s_entries_offset + count * sizeof(_Entry);
+		return (end + alignof(_Node*) - 1) / alignof(_Node*) * alignof(_Node*);
+	}
+
+	static SSTD_INLINE _Entry* _Entries(const _Node* node) noexcept {
+		return reinterpret_cast<_Entry*>(reinterpret_cast<uint8*>(const_cast<_Node*>(node)) + s_entries_offset);
+	}
+	static SSTD_INLINE _Node** _Children(const _Node* node) noexcept {
+		return reinterpret_cast<_Node**>(reinterpret_cast<uint8*>(const_cast<_Node*>(node)) + _Children_Offset(node->count));
+	}
+	static SSTD_INLINE uint32 _Child_Count(const _Node* node) noexcept {
+		return _Pop_Count(node->nodemap);
+	}
+
+	static SSTD_INLINE uint32 _Bit(const sizet& hash, const uint32& shift) noexcept {
+		return uint32(1) << ((hash >> shift) & 31);
+	}
+	// Position of bit among the set bits of map
+	static SSTD_INLINE uint32 _Index(const uint32& map, const uint32& bit) noexcept {
+		return _Pop_Count(map & (bit - 1));
+	}
+
+	// A node with room for count entries and children children, none of them constructed yet
+	static SSTD_INLINE _Node* _Alloc(const uint32& count, const uint32& children, const uint32& datamap, const uint32& nodemap) {
+		void* mem = ::operator new(_Children_Offset(count) + children * sizeof(_Node*));
+		_Node* node = new (mem) _Node;
+		node->refs.store(1, std::memory_order_relaxed);
+		node->datamap = datamap;
+		node->nodemap = nodemap;
+		node->count = count;
+		return node;
+	}
+
+	// Destroy the entries and the node, but not the children ( they got handed over )
+	static SSTD_INLINE void _Free_Shell(_Node* node) noexcept {
+		_Entry* entries = _Entries(node);
+		for (uint32 i = 0; i < node->count; ++i) {
+			entries[i].~_Entry();
+		}
+		node->~_Node();
+		::operator delete(node);
+	}
+
+	static SSTD_INLINE void _Retain(const _Node* node) noexcept {
+		if (node) {
+			const_cast<_Node*>(node)->refs.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+	static SSTD_INLINE void _Release(_Node* node) noexcept {
+		if (node == nullptr || node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+			return;
+		}
+		_Node** children = _Children(node);
+		for (uint32 i = 0, n = _Child_Count(node); i < n; ++i) {
+			_Release(children[i]);
+		}
+		_Free_Shell(node);
+	}
+
+	// Can node be changed in place, by the one holding the only reference to its parent
+	static SSTD_INLINE bool _Unique(const _Node* node) noexcept {
+		return node->refs.load(std::memory_order_acquire) == 1;
+	}
+
+	// A copy of node with the new bitmaps
+	// The branch bit gets *entry ( moved from ) or child ( handed over ) if given, every other branch comes from node
+	// If owned, node is used up: its entries are moved, its children handed over or released, and it's freed
+	// ( A child the caller already used up is set to nullptr first )
+	static _Node* _Reshape(_Node* node, const bool& owned, const uint32& datamap, const uint32& nodemap, const uint32& bit, _Entry* entry, _Node* child) {
+		_Node* res = _Alloc(_Pop_Count(datamap), _Pop_Count(nodemap), datamap, nodemap);
+		_Entry* dst = _Entries(res);
+		_Entry* src = _Entries(node);
+		for (uint32 m = datamap; m; m &= m - 1, ++dst) {
+			const uint32 b = m & (0 - m);
+			if (entry && b == bit) {
+				new (dst) _Entry(std::move(*entry));
+			}
+			else if (owned) {
+				new (dst) _Entry(std::move(src[_Index(node->datamap, b)]));
+			}
+			else {
+				new (dst) _Entry(src[_Index(node->datamap, b)]);
+			}
+		}
+		_Node** children = _Children(res);
+		_Node** old = _Children(node);
+		for (uint32 m = nodemap; m; m &= m - 1, ++children) {
+			const uint32 b = m & (0 - m);
+			if (child && b == bit) {
+				*children = child;
+			}
+			else {
+				*children = old[_Index(node->nodemap, b)];
+				if (!owned) {
+					_Retain(*children);
+				}
+			}
+		}
+		if (owned) {
+			for (uint32 m = node->nodemap; m; m &= m - 1) {
+				const uint32 b = m & (0 - m);
+				if (!(nodemap & b) || (child && b == bit)) {
+					_Release(old[_Index(node->nodemap, b)]);
+				}
+			}
+			_Free_Shell(node);
+		}
+		return res;
+	}
+
+	// A copy of a collision node without entry skip ( s_none to keep them all ) and with *entry at the end, if given
+	static _Node* _Collision(_Node* node, const bool& owned, const uint32& skip, _Entry* entry) {
+		_Node* res = _Alloc(node->count - (skip != s_none) + (entry != nullptr), 0, 0, 0);
+		_Entry* dst = _Entries(res);
+		_Entry* src = _Entries(node);
+		for (uint32 i = 0; i < node->count; ++i) {
+			if (i == skip) {
+				continue;
+			}
+			if (owned) {
+				new (dst++) _Entry(std::move(src[i]));
+			}
+			else {
+				new (dst++) _Entry(src[i]);
+			}
+		}
+		if (entry) {
+			new (dst) _Entry(std::move(*entry));
+		}
+		if (owned) {
+			_Free_Shell(node);
+		}
+		return res;
+	}
+
+	// The smallest subtree holding a and b, starting at shift
+	static _Node* _Merge(const uint32& shift, _Entry&& a, _Entry&& b) {
+		if (shift >= s_hash_bits) {
+			_Node* node = _Alloc(2, 0, 0, 0);
+			new (_Entries(node)) _Entry(std::move(a));
+			new (_Entries(node) + 1) _Entry(std::move(b));
+			return node;
+		}
+		const uint32 bit_a = _Bit(a.hash, shift);
+		const uint32 bit_b = _Bit(b.hash, shift);
+		if (bit_a == bit_b) {
+			_Node* node = _Alloc(0, 1, 0, bit_a);
+			*_Children(node) = _Merge(shift + s_bits, std::move(a), std::move(b));
+			return node;
+		}
+		_Node* node = _Alloc(2, 0, bit_a | bit_b, 0);
+		new (_Entries(node) + (bit_a > bit_b)) _Entry(std::move(a));
+		new (_Entries(node) + (bit_b > bit_a)) _Entry(std::move(b));
+		return node;
+	}
+
+	static const _EltT* _Find(const _Node* node, const sizet& hash, const _KeyT& key) noexcept {
+		for (uint32 shift = 0; node; shift += s_bits) {
+			const _Entry* entries = _Entries(node);
+			if (shift >= s_hash_bits) {
+				for (uint32 i = 0; i < node->count; ++i) {
+					if (entries[i].key == key) {
+						return &entries[i].elt;
+					}
+				}
+				return nullptr;
+			}
+			const uint32 bit = _Bit(hash, shift);
+			if (node->datamap & bit) {
+				const _Entry& entry = entries[_Index(node->datamap, bit)];
+				return entry.hash == hash && entry.key == key ? &entry.elt : nullptr;
+			}
+			if (!(node->nodemap & bit)) {
+				return nullptr;
+			}
+			node = _Children(node)[_Index(node->nodemap, bit)];
+		}
+		return nullptr;
+	}
+
+	// Insert or overwrite, returns the new node ( a reference the caller owns )
+	// If owned, node is used up ( changed in place and returned, or freed ), if not it's left as it is
+	// added is set if the key wasn't there yet
+	template<typename _K, typename _M>
+	static _Node* _Insert(_Node* node, const bool& owned, const uint32& shift, const sizet& hash, _K&& key, _M&& elt, bool& added) {
+		if (node == nullptr) {
+			added = true;
+			_Node* res = _Alloc(1, 0, shift >= s_hash_bits ? 0 : _Bit(hash, shift), 0);
+			new (_Entries(res)) _Entry{ hash, std::forward<_K>(key), std::forward<_M>(elt) };
+			return res;
+		}
+		_Entry* entries = _Entries(node);
+		if (shift >= s_hash_bits) {
+			for (uint32 i = 0; i < node->count; ++i) {
+				if (entries[i].key == key) {
+					_Node* res = owned ? node : _Collision(node, false, s_none, nullptr);
+					_Entries(res)[i].elt = std::forward<_M>(elt);
+					return res;
+				}
+			}
+			added = true;
+			_Entry entry{ hash, std::forward<_K>(key), std::forward<_M>(elt) };
+			return _Collision(node, owned, s_none, &entry);
+		}
+		const uint32 bit = _Bit(hash, shift);
+		if (node->datamap & bit) {
+			const uint32 ind = _Index(node->datamap, bit);
+			if (entries[ind].hash == hash && entries[ind].key == key) {
+				_Node* res = owned ? node : _Reshape(node, false, node->datamap, node->nodemap, 0, nullptr, nullptr);
+				_Entries(res)[ind].elt = std::forward<_M>(elt);
+				return res;
+			}
+			// Two keys on one branch, push both down a level
+			added = true;
+			_Node* sub = owned ?
+				_Merge(shift + s_bits, std::move(entries[ind]), _Entry{ hash, std::forward<_K>(key), std::forward<_M>(elt) }) :
+				_Merge(shift + s_bits, _Entry(entries[ind]), _Entry{ hash, std::forward<_K>(key), std::forward<_M>(elt) });
+			return _Reshape(node, owned, node->datamap & ~bit, node->nodemap | bit, bit, nullptr, sub);
+		}
+		if (node->nodemap & bit) {
+			_Node*& slot = _Children(node)[_Index(node->nodemap, bit)];
+			_Node* child = slot;
+			const bool child_owned = owned && _Unique(child);
+			_Node* res = _Insert(child, child_owned, shift + s_bits, hash, std::forward<_K>(key), std::forward<_M>(elt), added);
+			if (res == child) {
+				return node;
+			}
+			if (owned) {
+				slot = res;
+				if (!child_owned) {
+					_Release(child);
+				}
+				return node;
+			}
+			return _Reshape(node, false, node->datamap, node->nodemap, bit, nullptr, res);
+		}
+		added = true;
+		_Entry entry{ hash, std::forward<_K>(key), std::forward<_M>(elt) };
+		return _Reshape(node, owned, node->datamap | bit, node->nodemap, bit, &entry, nullptr);
+	}
+
+	// Returns the new node ( a reference the caller owns ), nullptr if nothing is left in it
+	// If the key isn't there, node is returned as it is
+	// A child left with a single entry and no children is pulled up into its parent, so the trie stays as shallow as possible
+	static _Node* _Erase(_Node* node, const bool& owned, const uint32& shift, const sizet& hash, const _KeyT& key, bool& removed) {
+		if (node == nullptr) {
+			return nullptr;
+		}
+		_Entry* entries = _Entries(node);
+		if (shift >= s_hash_bits) {
+			for (uint32 i = 0; i < node->count; ++i) {
+				if (entries[i].key == key) {
+					removed = true;
+					if (node->count == 1) {
+						if (owned) {
+							_Free_Shell(node);
+						}
+						return nullptr;
+					}
+					return _Collision(node, owned, i, nullptr);
+				}
+			}
+			return node;
+		}
+		const uint32 bit = _Bit(hash, shift);
+		if (node->datamap & bit) {
+			const _Entry& entry = entries[_Index(node->datamap, bit)];
+			if (entry.hash != hash || !(entry.key == key)) {
+				return node;
+			}
+			removed = true;
+			if (node->count == 1 && node->nodemap == 0) {
+				if (owned) {
+					_Free_Shell(node);
+				}
+				return nullptr;
+			}
+			return _Reshape(node, owned, node->datamap & ~bit, node->nodemap, 0, nullptr, nullptr);
+		}
+		if (!(node->nodemap & bit)) {
+			return node;
+		}
+		_Node*& slot = _Children(node)[_Index(node->nodemap, bit)];
+		_Node* child = slot;
+		const bool child_owned = owned && _Unique(child);
+		_Node* res = _Erase(child, child_owned, shift + s_bits, hash, key, removed);
+		if (!removed) {
+			return node;
+		}
+		if (res == nullptr || (res->count == 1 && res->nodemap == 0)) {
+			// The branch goes away, or turns back into a entry
+			if (owned) {
+				if (!child_owned) {
+					_Release(child);
+				}
+				slot = nullptr;
+			}
+			if (res == nullptr) {
+				if (node->count == 0 && _Child_Count(node) == 1) {
+					if (owned) {
+						_Free_Shell(node);
+					}
+					return nullptr;
+				}
+				return _Reshape(node, owned, node->datamap, node->nodemap & ~bit, 0, nullptr, nullptr);
+			}
+			_Entry entry(std::move(_Entries(res)[0]));
+			_Release(res);
+			return _Reshape(node, owned, node->datamap | bit, node->nodemap & ~bit, bit, &entry, nullptr);
+		}
+		if (res == child) {
+			return node;
+		}
+		if (owned) {
+			slot = res;
+			if (!child_owned) {
+				_Release(child);
+			}
+			return node;
+		}
+		return _Reshape(node, false, node->datamap, node->nodemap, bit, nullptr, res);
+	}
+};
+
+template<typename _KeyT, typename _EltT, typename _Hash>
+class persistent_map;
+template<typename _KeyT, typename _EltT, typename _Hash>
+class transient_map;
+template<typename _KeyT, typename _EltT>
+class _Persistent_Map_Iterator;
+
+// -----------------------------------------
+//
+//   Persistent map
+//
+// -----------------------------------------
+
+// A immutable map, every update returns a new version and leaves the old one as it is
+// Copying one is O(1) ( a reference count ), so a snapshot for a reader is just a copy, and any number of
+// versions can be read from any thread while a writer builds the next one
+// An update copies O(log32 n) nodes, everything else is shared with the version it came from
+//
+// For a lot of updates at once, transient() gives a transient_map that changes the nodes only it holds in place,
+// and persistent() turns it back into a persistent_map in O(1)
+
+template<
+	typename _KeyT,	// Key type
+	typename _EltT,		// Element type
+	typename _Hash = _Default_Hash<_KeyT> // Hash function
+>
+class persistent_map {
+	friend class transient_map<_KeyT, _EltT, _Hash>;
+	using _Trie = _Hamt<_KeyT, _EltT>;
+	using _Node = typename _Trie::_Node;
+public:
+	using iterator = _Persistent_Map_Iterator<_KeyT, _EltT>;
+	using const_iterator = _Persistent_Map_Iterator<_KeyT, _EltT>;
+	using transient_type = transient_map<_KeyT, _EltT, _Hash>;
+
+	// Default constructor
+	persistent_map() SSTD_DEFAULT;
+
+	// Constructor that initialize using a initializer list
+	// std::pair(Key, Element)
+	persistent_map(std::initializer_list<std::pair<_KeyT, _EltT> > list) {
+		transient_type res = transient();
+		for (const std::pair<_KeyT, _EltT>& pair : list) {
+			res.insert(pair.first, pair.second);
+		}
+		*this = res.persistent();
+	}
+
+	persistent_map(const persistent_map& other) noexcept :
+		m_root(other.m_root), m_size(other.m_size), m_Hasher(other.m_Hasher) {
+		_Trie::_Retain(m_root);
+	}
+	persistent_map(persistent_map&& other) noexcept :
+		m_root(std::exchange(other.m_root, nullptr)), m_size(std::exchange(other.m_size, 0)), m_Hasher(other.m_Hasher) {
+
+	}
+	persistent_map& operator=(const persistent_map& other) noexcept {
+		_Trie::_Retain(other.m_root);
+		_Trie::_Release(m_root);
+		m_root = other.m_root;
+		m_size = other.m_size;
+		m_Hasher = other.m_Hasher;
+		return *this;
+	}
+	persistent_map& operator=(persistent_map&& other) noexcept {
+		if (this != &other) {
+			_Trie::_Release(m_root);
+			m_root = std::exchange(other.m_root, nullptr);
+			m_size = std::exchange(other.m_size, 0);
+			m_Hasher = other.m_Hasher;
+		}
+		return *this;
+	}
+
+	~persistent_map() {
+		_Trie::_Release(m_root);
+	}
+
+	// A version with key set to elt
+	template<typename _M>
+	SSTD_INLINE persistent_map insert(const _KeyT& key, _M&& elt) const {
+		bool added = false;
+		_Node* root = _Trie::_Insert(m_root, false, 0, m_Hasher(key), key, std::forward<_M>(elt), added);
+		return persistent_map(root, m_size + added, m_Hasher);
+	}
+	SSTD_INLINE persistent_map insert(const std::pair<_KeyT, _EltT>& pair) const {
+		return insert(pair.first, pair.second);
+	}
+
+	// A version without key ( this version itself if key isn't there )
+	SSTD_INLINE persistent_map erase(const _KeyT& key) const {
+		bool removed = false;
+		_Node* root = _Trie::_Erase(m_root, false, 0, m_Hasher(key), key, removed);
+		if (!removed) {
+			return *this;
+		}
+		return persistent_map(root, m_size - 1, m_Hasher);
+	}
+
+	// nullptr if the key doesn't exist
+	SSTD_INLINE const _EltT* find(const _KeyT& key) const {
+		return _Trie::_Find(m_root, m_Hasher(key), key);
+	}
+	SSTD_INLINE bool contains(const _KeyT& key) const {
+		return find(key) != nullptr;
+	}
+
+	// Start a batch of in place updates, this version stays as it is
+	SSTD_INLINE transient_type transient() const {
+		_Trie::_Retain(m_root);
+		return transient_type(m_root, m_size, m_Hasher);
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR sizet size() const noexcept {
+		return m_size;
+	}
+	SSTD_INLINE SSTD_CONSTEXPR bool empty() const noexcept {
+		return m_size == 0;
+	}
+
+	SSTD_INLINE const_iterator begin() const noexcept {
+		return const_iterator(m_root);
+	}
+	SSTD_INLINE const_iterator end() const noexcept {
+		return const_iterator();
+	}
+	SSTD_INLINE const_iterator cbegin() const noexcept {
+		return begin();
+	}
+	SSTD_INLINE const_iterator cend() const noexcept {
+		return end();
+	}
+private:
+	_Node* m_root = nullptr;
+	sizet m_size = 0;
+
+	_Hash m_Hasher{};
+
+	// Takes over the reference to root
+	persistent_map(_Node* root, const sizet& _size, const _Hash& hasher) noexcept :
+		m_root(root), m_size(_size), m_Hasher(hasher) {
+
+	}
+};
+
+// -----------------------------------------
+//
+//   Transient map
+//
+// -----------------------------------------
+
+// A persistent_map under construction, from persistent_map::transient
+// Updates change the nodes that only this transient holds in place, the first update of a path copies the shared
+// nodes on it once, every later one on that path is free of copies and reference counting
+// Not thread safe, but the persistent_maps it came from or handed out can still be read from anywhere
+
+template<
+	typename _KeyT,	// Key type
+	typename _EltT,		// Element type
+	typename _Hash = _Default_Hash<_KeyT> // Hash function
+>
+class transient_map {
+	friend class persistent_map<_KeyT, _EltT, _Hash>;
+	using _Trie = _Hamt<_KeyT, _EltT>;
+	using _Node = typename _Trie::_Node;
+public:
+	using persistent_type = persistent_map<_KeyT, _EltT, _Hash>;
+
+	// Default constructor
+	transient_map() SSTD_DEFAULT;
+
+	transient_map(const transient_map&) = delete;
+	transient_map& operator=(const transient_map&) = delete;
+
+	transient_map(transient_map&& other) noexcept :
+		m_root(std::exchange(other.m_root, nullptr)), m_size(std::exchange(other.m_size, 0)), m_Hasher(other.m_Hasher) {
+
+	}
+	transient_map& operator=(transient_map&& other) noexcept {
+		if (this != &other) {
+			_Trie::_Release(m_root);
+			m_root = std::exchange(other.m_root, nullptr);
+			m_size = std::exchange(other.m_size, 0);
+			m_Hasher = other.m_Hasher;
+		}
+		return *this;
+	}
+
+	~transient_map() {
+		_Trie::_Release(m_root);
+	}
+
+	// Insert, or overwrite the element if the key already exists
+	template<typename _M>
+	SSTD_INLINE void insert(const _KeyT& key, _M&& elt) {
+		bool added = false;
+		_Node* old = m_root;
+		const bool owned = old && _Trie::_Unique(old);
+		m_root = _Trie::_Insert(old, owned, 0, m_Hasher(key), key, std::forward<_M>(elt), added);
+		if (!owned && old != m_root) {
+			_Trie::_Release(old);
+		}
+		m_size += added;
+	}
+	SSTD_INLINE void insert(const std::pair<_KeyT, _EltT>& pair) {
+		insert(pair.first, pair.second);
+	}
+
+	SSTD_INLINE void erase(const _KeyT& key) {
+		bool removed = false;
+		_Node* old = m_root;
+		const bool owned = old && _Trie::_Unique(old);
+		m_root = _Trie::_Erase(old, owned, 0, m_Hasher(key), key, removed);
+		if (!owned && old != m_root) {
+			_Trie::_Release(old);
+		}
+		m_size -= removed;
+	}
+
+	// nullptr if the key doesn't exist
+	SSTD_INLINE const _EltT* find(const _KeyT& key) const {
+		return _Trie::_Find(m_root, m_Hasher(key), key);
+	}
+	SSTD_INLINE bool contains(const _KeyT& key) const {
+		return find(key) != nullptr;
+	}
+
+	// Everything up to now as a persistent_map
+	// The transient can keep going, the next update of every path just copies it again
+	SSTD_INLINE persistent_type persistent() const noexcept {
+		_Trie::_Retain(m_root);
+		return persistent_type(m_root, m_size, m_Hasher);
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR sizet size() const noexcept {
+		return m_size;
+	}
+	SSTD_INLINE SSTD_CONSTEXPR bool empty() const noexcept {
+		return m_size == 0;
+	}
+private:
+	_Node* m_root = nullptr;
+	sizet m_size = 0;
+
+	_Hash m_Hasher{};
+
+	// Takes over the reference to root
+	transient_map(_Node* root, const sizet& _size, const _Hash& hasher) noexcept :
+		m_root(root), m_size(_size), m_Hasher(hasher) {
+
+	}
+};
+
+// -----------------------------------------
+//
+//   Const Forward Iterator
+//
+// -----------------------------------------
+
+// Depth first, the entries of a node before its children
+// Holds no reference, so it's only valid while the persistent_map it came from is alive
+
+template<
+	typename _KeyT,
+	typename _EltT
+>
+class _Persistent_Map_Iterator : public const_forward_iterator<std::pair<_KeyT, _EltT> > {
+	using _Trie = _Hamt<_KeyT, _EltT>;
+	using _Node = typename _Trie::_Node;
+	using _Entry = typename _Trie::_Entry;
+public:
+	using reference = std::pair<const _KeyT&, const _EltT&>;
+	using pointer = _Arrow_Proxy<reference>;
+
+	_Persistent_Map_Iterator() noexcept SSTD_DEFAULT;
+	SSTD_EXPLICIT _Persistent_Map_Iterator(const _Node* root) noexcept {
+		if (root) {
+			m_nodes[0] = root;
+			m_pos[0] = 0;
+			m_depth = 1;
+			_Advance();
+		}
+	}
+
+	SSTD_INLINE _Persistent_Map_Iterator& operator++() noexcept {
+		_Advance();
+		return *this;
+	}
+	SSTD_INLINE _Persistent_Map_Iterator operator++(int) noexcept {
+		_Persistent_Map_Iterator tmp = *this;
+		_Advance();
+		return tmp;
+	}
+
+	SSTD_INLINE reference operator*() const noexcept {
+		return { m_entry->key, m_entry->elt };
+	}
+	SSTD_INLINE pointer operator->() const noexcept {
+		return { **this };
+	}
+
+	SSTD_INLINE bool operator==(const _Persistent_Map_Iterator& other) const noexcept {
+		return m_entry == other.m_entry;
+	}
+
+	SSTD_INLINE bool operator!=(const _Persistent_Map_Iterator& other) const noexcept {
+		return m_entry != other.m_entry;
+	}
+private:
+	// The path down to the current entry, m_pos is the next entry ( then child ) to visit in every node
+	const _Node* m_nodes[_Trie::s_max_depth] = {};
+	uint32 m_pos[_Trie::s_max_depth] = {};
+	uint32 m_depth = 0;
+	const _Entry* m_entry = nullptr;
+
+	SSTD_INLINE void _Advance() noexcept {
+		while (m_depth) {
+			const _Node* node = m_nodes[m_depth - 1];
+			const uint32 pos = m_pos[m_depth - 1]++;
+			if (pos < node->count) {
+				m_entry = _Trie::_Entries(node) + pos;
+				return;
+			}
+			if (pos - node->count < _Trie::_Child_Count(node)) {
+				m_nodes[m_depth] = _Trie::_Children(node)[pos - node->count];
+				m_pos[m_depth] = 0;
+				++m_depth;
+				continue;
+			}
+			--m_depth;
+		}
+		m_entry = nullptr;
+	}
+};
+
+SSTD_END
+
+#endif
@@ -0,0 +1,441 @@
+#ifndef SSTD_READ_MOSTLY_UNORDERED_MAP_INCLUDED
+#define SSTD_READ_MOSTLY_UNORDERED_MAP_INCLUDED
+
+#include "core.hpp"
+#include "unordered_map.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+SSTD_BEGIN
+
+// A hash table for data that is read all the time and written once in a while
+// Same control bytes, groups and probing functors as sstd::unordered_map
+//
+// Readers never take a lock, the only thing they write is a counter of their own ( see _Reader_Slot ),
+// one cache line per thread that only the writer ever looks at
+// Every group of slots has a version counter ( a seqlock ), the writer makes it odd while it changes the group
+// and even again when it's done. A reader copies what it needs out of the group,
+// and starts the group over if the version was odd or has changed in the meantime
+//
+// Writers take a mutex, and a growing ( or rebuilt ) table is built on the side and then published with one atomic store
+// Readers that are still on the old table see a consistent snapshot of it, so the old table is retired instead of freed
+// Retired tables are freed by the next writer once every reader that could have seen them is done:
+// a reader counts itself in under the current epoch, a writer flips the epoch and frees what was retired before the flip
+// as soon as nobody is counted under the old one anymore ( a grace period, same idea as RCU )
+//
+// Readers copy keys and elements out of slots that may be written at the same time,
+// so both have to be trivially copyable
+
+template<
+	typename _KeyT,	// Key type
+	typename _EltT,		// Element type
+	typename _Hash = _Default_Hash<_KeyT>, // Hash function
+	typename _ProbT = _Double_Hash_Prob<_KeyT, _Hash> // probing function
+>
+class read_mostly_unordered_map {
+	SSTD_STATIC_ASSERT(std::is_trivially_copyable<_KeyT>::value, "Readers copy keys while they may be written");
+	SSTD_STATIC_ASSERT(std::is_trivially_copyable<_EltT>::value, "Readers copy elements while they may be written");
+	SSTD_STATIC_ASSERT(!_Is_Robin_Hood<_ProbT>::value, "Robin Hood moves elements around, readers need them to stay put");
+private:
+	struct _Map_Element {
+		_KeyT key;
+		_EltT elt;
+	};
+
+	struct _Table {
+		int8* ctrl = nullptr;
+		_Map_Element* slots = nullptr;
+		// One seqlock per group
+		std::atomic<uint32>* versions = nullptr;
+		sizet capacity = 0;
+		sizet deleted = 0;
+		// The next older table, once this one is retired
+		_Table* retired = nullptr;
+	};
+
+	// Readers in flight under each epoch parity, one cache line per slot
+	// Every live thread has a slot of its own, threads only share one when more than s_reader_slots of them read at once
+	struct alignas(64) _Reader_Count {
+		std::atomic<uint32> count[2] = { 0, 0 };
+	};
+	static SSTD_CONSTEXPR sizet s_reader_slots = 128;
+
+	// A thread's claim on a slot, given back when the thread exits so the next thread can have it
+	// If every slot is taken, the thread shares one round robin instead ( the counts still add up, the line just bounces )
+	struct _Reader_Id {
+		sizet slot = 0;
+		bool owned = false;
+
+		_Reader_Id() {
+			for (sizet i = 0; i < s_reader_slots; ++i) {
+				if (!_Taken()[i].load(std::memory_order_relaxed) && !_Taken()[i].exchange(true, std::memory_order_acquire)) {
+					slot = i;
+					owned = true;
+					return;
+				}
+			}
+			static std::atomic<sizet> next{ 0 };
+			slot = next.fetch_add(1, std::memory_order_relaxed) % s_reader_slots;
+		}
+		~_Reader_Id() {
+			if (owned) {
+				_Taken()[slot].store(false, std::memory_order_release);
+			}
+		}
+	};
+public:
+
+	// Default constructor
+	read_mostly_unordered_map() {
+		m_table.store(_Malloc_Table(16), std::memory_order_relaxed); // same kind of magic number as unordered_map
+	}
+
+	read_mostly_unordered_map(std::initializer_list<std::pair<_KeyT, _EltT> > list) :
+		read_mostly_unordered_map() {
+		for (const std::pair<_KeyT, _EltT>& pair : list) {
+			insert(pair.first, pair.second);
+		}
+	}
+
+	read_mostly_unordered_map(const read_mostly_unordered_map&) = delete;
+	read_mostly_unordered_map& operator=(const read_mostly_unordered_map&) = delete;
+
+	// No reader can be left at this point, everything goes
+	~read_mostly_unordered_map() {
+		_Free_Retired(m_retired);
+		_Free_Retired(m_waiting);
+		_Free_Table(m_table.load(std::memory_order_relaxed));
+	}
+
+	// -----------------------------------------
+	//   Readers ( lock free )
+	// -----------------------------------------
+
+	// Copy the element out, returns false if the key doesn't exist
+	SSTD_INLINE bool find(const _KeyT& key, _EltT& out) const {
+		return _Read(key, &out);
+	}
+
+	SSTD_INLINE bool contains(const _KeyT& key) const {
+		return _Read(key, nullptr);
+	}
+
+	// Only a snapshot, the writer can change it right after
+	SSTD_INLINE sizet size() const noexcept {
+		return m_size.load(std::memory_order_relaxed);
+	}
+	SSTD_INLINE bool empty() const noexcept {
+		return size() == 0;
+	}
+
+	// -----------------------------------------
+	//   Writers ( one at a time )
+	// -----------------------------------------
+
+	// Insert the key, or overwrite the element if the key already exists
+	SSTD_INLINE void insert(const _KeyT& key, const _EltT& elt) {
+		std::lock_guard<std::mutex> guard(m_write_lock);
+		_Table* tab = m_table.load(std::memory_order_relaxed);
+		const sizet hash = m_Hasher(key);
+		sizet ind = _Find_Index(tab, key, hash);
+		if (ind != tab->capacity) {
+			_Write_Begin(tab, ind);
+			tab->slots[ind].elt = elt;
+			_Write_End(tab, ind);
+			return;
+		}
+		const sizet cur_size = m_size.load(std::memory_order_relaxed);
+		if (static_cast<Decimal>(cur_size + tab->deleted + 1) > tab->capacity * m_max_load_factor) {
+			tab = _Publish(cur_size < tab->deleted ? tab->capacity : tab->capacity * 2);
+		}
+		ind = _Find_Free(tab, hash);
+		while (ind == tab->capacity) {
+			tab = _Publish(tab->capacity * 2);
+			ind = _Find_Free(tab, hash);
+		}
+		if (tab->ctrl[ind] == _Ctrl::Deleted) {
+			--tab->deleted;
+		}
+		_Write_Begin(tab, ind);
+		new (&tab->slots[ind].key) _KeyT(key);
+		new (&tab->slots[ind].elt) _EltT(elt);
+		tab->ctrl[ind] = _Ctrl::h2(hash);
+		_Write_End(tab, ind);
+		m_size.store(cur_size + 1, std::memory_order_relaxed);
+		_Try_Reclaim();
+	}
+	SSTD_INLINE void insert(const std::pair<_KeyT, _EltT>& pair) {
+		insert(pair.first, pair.second);
+	}
+
+	SSTD_INLINE void erase(const _KeyT& key) {
+		std::lock_guard<std::mutex> guard(m_write_lock);
+		_Table* tab = m_table.load(std::memory_order_relaxed);
+		const sizet ind = _Find_Index(tab, key, m_Hasher(key));
+		if (ind == tab->capacity) {
+			return;
+		}
+		const sizet base = ind / _Group::width * _Group::width;
+		_Write_Begin(tab, ind);
+		// Same rule as unordered_map, a group with an Empty slot already ends every probe sequence
+		if (_Group(tab->ctrl + base).match_empty()) {
+			tab->ctrl[ind] = _Ctrl::Empty;
+		}
+		else {
+			tab->ctrl[ind] = _Ctrl::Deleted;
+			++tab->deleted;
+		}
+		_Write_End(tab, ind);
+		m_size.store(m_size.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+		_Try_Reclaim();
+	}
+
+	// Free every retired table, waiting for the readers that may still be on one
+	// Writers already do this on the fly, this is for when the writes stop and the memory should go right away
+	SSTD_INLINE void reclaim() {
+		std::lock_guard<std::mutex> guard(m_write_lock);
+		while (!_Try_Reclaim()) {
+			std::this_thread::yield();
+		}
+	}
+
+	SSTD_INLINE sizet capacity() const noexcept {
+		return m_table.load(std::memory_order_acquire)->capacity;
+	}
+private:
+	std::atomic<_Table*> m_table{ nullptr };
+	// Retired since the last epoch flip
+	_Table* m_retired = nullptr;
+	// Retired before the last epoch flip, freed once no reader is counted under the old epoch
+	_Table* m_waiting = nullptr;
+	std::atomic<uint32> m_epoch{ 0 };
+	mutable _Reader_Count m_readers[s_reader_slots];
+	std::atomic<sizet> m_size{ 0 };
+	std::mutex m_write_lock;
+
+	const _Hash m_Hasher{};
+	const _ProbT m_prob{};
+
+	Decimal m_max_load_factor = 0.5;
+
+	// Control bytes are padded to a full group, so a group load never reads past the array
+	static SSTD_INLINE SSTD_CONSTEXPR sizet _Ctrl_Size(const sizet& capacity) noexcept {
+		return (capacity + _Group::width - 1) / _Group::width * _Group::width;
+	}
+
+	static SSTD_INLINE _Table* _Malloc_Table(const sizet& memsize) {
+		_Table* tab = new _Table();
+		tab->capacity = _Probe_Reduce<_ProbT>::type::capacity(memsize);
+		const sizet ctrl_size = _Ctrl_Size(tab->capacity);
+		tab->slots = (_Map_Element*)malloc(sizeof(_Map_Element) * tab->capacity);
+		tab->ctrl = (int8*)malloc(ctrl_size);
+		std::memset(tab->ctrl, _Ctrl::Empty, tab->capacity);
+		std::memset(tab->ctrl + tab->capacity, _Ctrl::Sentinel, ctrl_size - tab->capacity);
+		tab->versions = (std::atomic<uint32>*)malloc(sizeof(std::atomic<uint32>) * (ctrl_size / _Group::width));
+		for (sizet i = 0; i < ctrl_size / _Group::width; ++i) {
+			new (&tab->versions[i]) std::atomic<uint32>(0);
+		}
+		return tab;
+	}
+
+	// Keys and elements are trivially copyable, nothing to destruct
+	static SSTD_INLINE void _Free_Table(_Table* tab) {
+		free(tab->slots);
+		free(tab->ctrl);
+		free(tab->versions);
+		delete tab;
+	}
+
+	static SSTD_INLINE void _Free_Retired(_Table*& tab) {
+		while (tab != nullptr) {
+			_Table* next = tab->retired;
+			_Free_Table(tab);
+			tab = next;
+		}
+	}
+
+	// Which slots belong to a live thread, the same for every map so a thread has one slot in all of them
+	static SSTD_INLINE std::atomic<bool>* _Taken() noexcept {
+		static std::atomic<bool> taken[s_reader_slots] = {};
+		return taken;
+	}
+
+	// Slot of the calling thread, claimed the first time it reads
+	static SSTD_INLINE sizet _Reader_Slot() noexcept {
+		thread_local const _Reader_Id id;
+		return id.slot;
+	}
+
+	SSTD_INLINE bool _No_Readers(const uint32& parity) const noexcept {
+		for (sizet i = 0; i < s_reader_slots; ++i) {
+			if (m_readers[i].count[parity].load() != 0) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Free what's past its grace period, and start the grace period of the tables retired since
+	// Never waits, returns true if nothing is left retired
+	// Why it's safe ( every step below and in _Read is seq_cst ):
+	// A reader only loads a table after it saw the epoch it's counted under still current ( see _Read ),
+	// so a flip from that epoch comes after the count and sees it, and what's retired before the flip waits for the reader
+	// The epoch only flips again once the old parity has drained, so a reader can never be counted under
+	// a parity that is 2 flips old while it's still on a table
+	SSTD_INLINE bool _Try_Reclaim() {
+		if (m_waiting != nullptr) {
+			if (!_No_Readers((m_epoch.load(std::memory_order_relaxed) & 1) ^ 1)) {
+				return false;
+			}
+			_Free_Retired(m_waiting);
+		}
+		if (m_retired == nullptr) {
+			return true;
+		}
+		const uint32 old_parity = m_epoch.fetch_add(1) & 1;
+		m_waiting = std::exchange(m_retired, nullptr);
+		if (!_No_Readers(old_parity)) {
+			return false;
+		}
+		_Free_Retired(m_waiting);
+		return true;
+	}
+
+	// Build a table of new_size with everything in the current one, and swap it in for the readers
+	SSTD_INLINE _Table* _Publish(const sizet& new_size) {
+		_Table* old_tab = m_table.load(std::memory_order_relaxed);
+		_Table* tab = _Malloc_Table(new_size);
+		for (sizet i = 0; i < old_tab->capacity; ++i) {
+			if (!_Ctrl::is_full(old_tab->ctrl[i])) {
+				continue;
+			}
+			const sizet hash = m_Hasher(old_tab->slots[i].key);
+			const sizet ind = _Find_Free(tab, hash);
+			SSTD_ASSERT(ind != tab->capacity);
+			new (&tab->slots[ind]) _Map_Element(old_tab->slots[i]);
+			tab->ctrl[ind] = _Ctrl::h2(hash);
+		}
+		m_table.store(tab);
+		old_tab->retired = m_retired;
+		m_retired = old_tab;
+		return tab;
+	}
+
+	// Make the version of the group odd, readers of that group wait until _Write_End
+	static SSTD_INLINE void _Write_Begin(_Table* tab, const sizet& ind) noexcept {
+		std::atomic<uint32>& version = tab->versions[ind / _Group::width];
+		version.store(version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+	}
+	static SSTD_INLINE void _Write_End(_Table* tab, const sizet& ind) noexcept {
+		std::atomic<uint32>& version = tab->versions[ind / _Group::width];
+		version.store(version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	// Writer side lookups, the writer is the only one changing the table so no versions needed
+	SSTD_INLINE sizet _Find_Index(const _Table* tab, const _KeyT& key, const sizet& hash) const {
+		const sizet groups = _Ctrl_Size(tab->capacity) / _Group::width;
+		const int8 h2 = _Ctrl::h2(hash);
+		for (sizet i = 0; i < groups; ++i) {
+			const sizet base = m_prob(hash, i, groups) * _Group::width;
+			const _Group group(tab->ctrl + base);
+			for (uint64 mask = group.match(h2); mask; mask &= mask - 1) {
+				const sizet ind = base + (_Count_Trailing_Zeros(mask) >> _Group::shift);
+				if (tab->slots[ind].key == key) {
+					return ind;
+				}
+			}
+			if (group.match_empty()) {
+				break;
+			}
+		}
+		return tab->capacity;
+	}
+
+	SSTD_INLINE sizet _Find_Free(const _Table* tab, const sizet& hash) const {
+		const sizet groups = _Ctrl_Size(tab->capacity) / _Group::width;
+		for (sizet i = 0; i < groups; ++i) {
+			const sizet base = m_prob(hash, i, groups) * _Group::width;
+			const uint64 mask = _Group(tab->ctrl + base).match_empty_or_deleted();
+			if (mask) {
+				return base + (_Count_Trailing_Zeros(mask) >> _Group::shift);
+			}
+		}
+		return tab->capacity;
+	}
+
+	// The reader side lookup
+	// Every group is read inside its seqlock, what we copied out only counts if the version didn't move
+	SSTD_INLINE bool _Read(const _KeyT& key, _EltT* out) const {
+		// Counted in until the reader is done with the table, see _Try_Reclaim
+		// The epoch can flip between reading it and counting in, the count only holds if the parity is still the same after
+		_Reader_Count& counts = m_readers[_Reader_Slot()];
+		uint32 parity = m_epoch.load() & 1;
+		counts.count[parity].fetch_add(1);
+		while ((m_epoch.load() & 1) != parity) {
+			counts.count[parity].fetch_sub(1, std::memory_order_relaxed);
+			parity ^= 1;
+			counts.count[parity].fetch_add(1);
+		}
+		std::atomic<uint32>& count = counts.count[parity];
+		const bool res = _Read_Table(m_table.load(), key, out);
+		count.fetch_sub(1, std::memory_order_release);
+		return res;
+	}
+
+	SSTD_INLINE bool _Read_Table(const _Table* tab, const _KeyT& key, _EltT* out) const {
+		const sizet hash = m_Hasher(key);
+		const int8 h2 = _Ctrl::h2(hash);
+		const sizet groups = _Ctrl_Size(tab->capacity) / _Group::width;
+		for (sizet i = 0; i < groups; ++i) {
+			const sizet base = m_prob(hash, i, groups) * _Group::width;
+			const std::atomic<uint32>& version = tab->versions[base / _Group::width];
+			while (true) {
+				const uint32 before = version.load(std::memory_order_acquire);
+				if (before & 1) {
+					continue;
+				}
+				const _Group group(tab->ctrl + base);
+				bool found = false;
+				alignas(_EltT) unsigned char elt[sizeof(_EltT)];
+				for (uint64 mask = group.match(h2); mask; mask &= mask - 1) {
+					const sizet ind = base + (_Count_Trailing_Zeros(mask) >> _Group::shift);
+					alignas(_KeyT) unsigned char slot_key[sizeof(_KeyT)];
+					std::memcpy(slot_key, &tab->slots[ind].key, sizeof(_KeyT));
+					if (*reinterpret_cast<const _KeyT*>(slot_key) == key) {
+						std::memcpy(elt, &tab->slots[ind].elt, sizeof(_EltT));
+						found = true;
+						break;
+					}
+				}
+				const bool stop = group.match_empty() != 0;
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (version.load(std::memory_order_relaxed) != before) {
+					// The writer was here, read the group again
+					continue;
+				}
+				if (found) {
+					if (out != nullptr) {
+						std::memcpy(out, elt, sizeof(_EltT));
+					}
+					return true;
+				}
+				if (stop) {
+					return false;
+				}
+				break;
+			}
+		}
+		return false;
+	}
+};
+
+SSTD_END
+
+#endif
@@ -0,0 +1,617 @@
+#ifndef SSTD_SMALL_UNORDERED_MAP_INCLUDED
+#define SSTD_SMALL_UNORDERED_MAP_INCLUDED
+
+#include "core.hpp"
+#include "Iterator.hpp"
+#include "unordered_map.hpp"
+
+#include <cstring>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+
+SSTD_BEGIN
+
+template<typename _KeyT, typename _EltT, sizet _N, typename _Hash, typename _ProbT>
+class _Small_Unordered_Map_Iterator;
+template<typename _KeyT, typename _EltT, sizet _N, typename _Hash, typename _ProbT>
+class _Small_Unordered_Map_Const_Iterator;
+
+// A map for a handful of elements
+// Up to _N elements live inside the object itself, keys in one array and elements in another,
+// so an empty or small map never touches the heap
+// Lookups just scan the key array, for number / pointer / enum keys that's a SIMD compare of a whole group of keys at once
+// The insert that would make it _N + 1 elements moves everything into a sstd::unordered_map,
+// and it stays there until clear()
+//
+// Erasing an inline element moves the last one into its place, so the order isn't stable
+
+template<
+	typename _KeyT,	// Key type
+	typename _EltT,		// Element type
+	sizet _N = 8, // Elements kept inline
+	typename _Hash = _Default_Hash<_KeyT>, // Hash function, once it moved to the table
+	typename _ProbT = _Double_Hash_Prob<_KeyT, _Hash> // probing function, once it moved to the table
+>
+class small_unordered_map {
+	SSTD_STATIC_ASSERT(_N > 0, "Keep at least one element inline");
+	SSTD_STATIC_ASSERT(_N < 0x100000000ull, "That's not small anymore");
+public:
+	friend class _Small_Unordered_Map_Iterator<_KeyT, _EltT, _N, _Hash, _ProbT>;
+	friend class _Small_Unordered_Map_Const_Iterator<_KeyT, _EltT, _N, _Hash, _ProbT>;
+	using map_type = unordered_map<_KeyT, _EltT, _Hash, _ProbT>;
+	using iterator = _Small_Unordered_Map_Iterator<_KeyT, _EltT, _N, _Hash, _ProbT>;
+	using const_iterator = _Small_Unordered_Map_Const_Iterator<_KeyT, _EltT, _N, _Hash, _ProbT>;
+private:
+	// Keys that can be compared byte by byte, a group of them in one SIMD compare
+	static SSTD_CONSTEXPR bool s_simd_keys =
+		(std::is_integral<_KeyT>::value || std::is_enum<_KeyT>::value || std::is_pointer<_KeyT>::value) &&
+		(sizeof(_KeyT) == 1 || sizeof(_KeyT) == 2 || sizeof(_KeyT) == 4 || sizeof(_KeyT) == 8);
+#if defined(SSTD_GROUP_AVX2)
+	static SSTD_CONSTEXPR sizet s_scan_width = 32;
+#elif defined(SSTD_GROUP_SSE2)
+	static SSTD_CONSTEXPR sizet s_scan_width = 16;
+#else
+	static SSTD_CONSTEXPR sizet s_scan_width = 8;
+#endif
+	// The key array is padded to a whole scan, so the last load never reads past it
+	static SSTD_CONSTEXPR sizet s_key_bytes = s_simd_keys ?
+		(sizeof(_KeyT) * _N + s_scan_width - 1) / s_scan_width * s_scan_width :
+		sizeof(_KeyT) * _N;
+public:
+
+	// Default constructor, doesn't allocate anything
+	small_unordered_map() noexcept SSTD_DEFAULT;
+
+	// Constructor that initialize using a initializer list
+	// std::pair(Key, Element)
+	small_unordered_map(std::initializer_list<std::pair<_KeyT, _EltT> > list) {
+		reserve(list.size());
+		for (const std::pair<_KeyT, _EltT>& pair : list) {
+			insert(pair.first, pair.second);
+		}
+	}
+
+	small_unordered_map(const small_unordered_map& other) {
+		_Copy_From(other);
+	}
+	small_unordered_map(small_unordered_map&& other) noexcept(std::is_nothrow_move_constructible<_KeyT>::value && std::is_nothrow_move_constructible<_EltT>::value) {
+		_Move_From(std::move(other));
+	}
+
+	small_unordered_map& operator=(const small_unordered_map& other) {
+		if (this != &other) {
+			clear();
+			_Copy_From(other);
+		}
+		return *this;
+	}
+	small_unordered_map& operator=(small_unordered_map&& other) noexcept(std::is_nothrow_move_constructible<_KeyT>::value && std::is_nothrow_move_constructible<_EltT>::value) {
+		if (this != &other) {
+			clear();
+			_Move_From(std::move(other));
+		}
+		return *this;
+	}
+
+	~small_unordered_map() {
+		clear();
+	}
+
+	// Back to an empty inline map
+	SSTD_INLINE void clear() {
+		_Destroy_Inline();
+		delete m_table;
+		m_table = nullptr;
+	}
+
+	// Insert, or overwrite the element if the key already exists
+	SSTD_INLINE void insert(const _KeyT& key, const _EltT& elt) {
+		insert_or_assign(key, elt);
+	}
+	SSTD_INLINE void insert(const _KeyT& key, _EltT&& elt) {
+		insert_or_assign(key, std::move(elt));
+	}
+	SSTD_INLINE void insert(const std::pair<_KeyT, _EltT>& pair) {
+		insert_or_assign(pair.first, pair.second);
+	}
+	SSTD_INLINE void insert(std::pair<_KeyT, _EltT>&& pair) {
+		insert_or_assign(std::move(pair.first), std::move(pair.second));
+	}
+
+	// Same as sstd::unordered_map::try_emplace
+	template<typename... _Args>
+	SSTD_INLINE std::pair<iterator, bool> try_emplace(const _KeyT& key, _Args&&... args) {
+		return _Try_Emplace(key, std::forward<_Args>(args)...);
+	}
+	template<typename... _Args>
+	SSTD_INLINE std::pair<iterator, bool> try_emplace(_KeyT&& key, _Args&&... args) {
+		return _Try_Emplace(std::move(key), std::forward<_Args>(args)...);
+	}
+
+	// Same as sstd::unordered_map::insert_or_assign
+	template<typename _M>
+	SSTD_INLINE std::pair<iterator, bool> insert_or_assign(const _KeyT& key, _M&& obj) {
+		return _Insert_Or_Assign(key, std::forward<_M>(obj));
+	}
+	template<typename _M>
+	SSTD_INLINE std::pair<iterator, bool> insert_or_assign(_KeyT&& key, _M&& obj) {
+		return _Insert_Or_Assign(std::move(key), std::forward<_M>(obj));
+	}
+
+	// ( key, element ), an existing key is left alone
+	template<typename _K, typename _E>
+	SSTD_INLINE std::pair<iterator, bool> emplace(_K&& key, _E&& elt) {
+		if constexpr (std::is_same<typename std::decay<_K>::type, _KeyT>::value) {
+			return _Try_Emplace(std::forward<_K>(key), std::forward<_E>(elt));
+		}
+		else {
+			return _Try_Emplace(_KeyT(std::forward<_K>(key)), std::forward<_E>(elt));
+		}
+	}
+
+	SSTD_INLINE void erase(const _KeyT& key) {
+		_Erase(key);
+	}
+	template<typename _K, typename _H = _Hash, typename = typename std::enable_if<_Is_Transparent<_H>::value>::type>
+	SSTD_INLINE void erase(const _K& key) {
+		_Erase(key);
+	}
+
+	SSTD_INLINE iterator find(const _KeyT& key) {
+		return _Search<iterator>(this, key);
+	}
+	SSTD_INLINE const_iterator find(const _KeyT& key) const {
+		return _Search<const_iterator>(this, key);
+	}
+	template<typename _K, typename _H = _Hash, typename = typename std::enable_if<_Is_Transparent<_H>::value>::type>
+	SSTD_INLINE iterator find(const _K& key) {
+		return _Search<iterator>(this, key);
+	}
+	template<typename _K, typename _H = _Hash, typename = typename std::enable_if<_Is_Transparent<_H>::value>::type>
+	SSTD_INLINE const_iterator find(const _K& key) const {
+		return _Search<const_iterator>(this, key);
+	}
+
+	SSTD_INLINE bool contains(const _KeyT& key) const {
+		return m_table ? m_table->contains(key) : _Find_Inline(key) != m_count;
+	}
+	template<typename _K, typename _H = _Hash, typename = typename std::enable_if<_Is_Transparent<_H>::value>::type>
+	SSTD_INLINE bool contains(const _K& key) const {
+		return m_table ? m_table->contains(key) : _Find_Inline(key) != m_count;
+	}
+
+	// Construct a empty value into the map if the key doesn't exist
+	SSTD_INLINE _EltT& operator[](const _KeyT& key) {
+		if (m_table == nullptr && (m_count < _N || _Find_Inline(key) != m_count)) {
+			return _Elt(_Try_Emplace(key).first.m_ind);
+		}
+		return _Table()[key];
+	}
+	SSTD_INLINE _EltT& operator[](_KeyT&& key) {
+		if (m_table == nullptr && (m_count < _N || _Find_Inline(key) != m_count)) {
+			return _Elt(_Try_Emplace(std::move(key)).first.m_ind);
+		}
+		return _Table()[std::move(key)];
+	}
+
+	// Move to the table right away if _size elements won't fit inline
+	SSTD_INLINE void reserve(const sizet& _size) {
+		if (m_table) {
+			m_table->reserve(_size);
+		}
+		else if (_size > _N) {
+			_Spill(_size);
+		}
+	}
+
+	SSTD_INLINE sizet size() const noexcept {
+		return m_table ? m_table->size() : m_count;
+	}
+	SSTD_INLINE bool empty() const noexcept {
+		return size() == 0;
+	}
+	// Are the elements still inside the object
+	SSTD_INLINE bool is_inline() const noexcept {
+		return m_table == nullptr;
+	}
+	static SSTD_INLINE SSTD_CONSTEXPR sizet inline_capacity() noexcept {
+		return _N;
+	}
+
+	SSTD_INLINE iterator begin() noexcept {
+		return m_table ? iterator(this, m_table->begin()) : iterator(this, 0);
+	}
+	SSTD_INLINE const_iterator begin() const noexcept {
+		return m_table ? const_iterator(this, static_cast<const map_type*>(m_table)->begin()) : const_iterator(this, 0);
+	}
+	SSTD_INLINE iterator end() noexcept {
+		return m_table ? iterator(this, m_table->end()) : iterator(this, m_count);
+	}
+	SSTD_INLINE const_iterator end() const noexcept {
+		return m_table ? const_iterator(this, static_cast<const map_type*>(m_table)->end()) : const_iterator(this, m_count);
+	}
+	SSTD_INLINE const_iterator cbegin() const noexcept {
+		return begin();
+	}
+	SSTD_INLINE const_iterator cend() const noexcept {
+		return end();
+	}
+private:
+	alignas(_KeyT) unsigned char m_keys[s_key_bytes] = {};
+	alignas(_EltT) unsigned char m_elts[sizeof(_EltT) * _N];
+	// Inline elements, only while m_table is nullptr
+	uint32 m_count = 0;
+	map_type* m_table = nullptr;
+
+	SSTD_INLINE _KeyT& _Key(const sizet& i) noexcept {
+		return reinterpret_cast<_KeyT*>(m_keys)[i];
+	}
+	SSTD_INLINE const _KeyT& _Key(const sizet& i) const noexcept {
+		return reinterpret_cast<const _KeyT*>(m_keys)[i];
+	}
+	SSTD_INLINE _EltT& _Elt(const sizet& i) noexcept {
+		return reinterpret_cast<_EltT*>(m_elts)[i];
+	}
+	SSTD_INLINE const _EltT& _Elt(const sizet& i) const noexcept {
+		return reinterpret_cast<const _EltT*>(m_elts)[i];
+	}
+
+	// Index of the key in the inline arrays, or m_count
+	template<typename _K>
+	SSTD_INLINE sizet _Find_Inline(const _K& key) const {
+		if constexpr (s_simd_keys && std::is_same<_K, _KeyT>::value) {
+			return _Scan(key);
+		}
+		else {
+			for (sizet i = 0; i < m_count; ++i) {
+				if (_Key(i) == key) {
+					return i;
+				}
+			}
+			return m_count;
+		}
+	}
+
+	// Compare s_scan_width bytes of keys at once, a key matches if all of its bytes do
+	// Whatever sits behind the last inline key is masked off by m_count
+	SSTD_INLINE sizet _Scan(const _KeyT& key) const noexcept {
+		SSTD_CONSTEXPR sizet size = sizeof(_KeyT);
+		uint64 bits = 0;
+		std::memcpy(&bits, &key, size);
+		const sizet used = m_count * size;
+		for (sizet off = 0; off < used; off += s_scan_width) {
+			uint64 mask = _Match_Bytes(m_keys + off, bits);
+			// Bit j stays set only if bits j .. j + size - 1 are all set, then keep the first byte of every key
+			for (sizet shift = 1; shift < size; shift <<= 1) {
+				mask &= mask >> shift;
+			}
+			mask &= _Key_Starts();
+			if (mask) {
+				const sizet ind = (off + _Count_Trailing_Zeros(mask)) / size;
+				return ind < m_count ? ind : m_count;
+			}
+		}
+		return m_count;
+	}
+
+	// A bit at the first byte of every key in a scan
+	static SSTD_INLINE SSTD_CONSTEXPR uint64 _Key_Starts() noexcept {
+		uint64 res = 0;
+		for (sizet i = 0; i < s_scan_width; i += sizeof(_KeyT)) {
+			res |= uint64(1) << i;
+		}
+		return res;
+	}
+
+	// One bit per byte of p that equals the same byte of the key repeated over the whole scan
+	static SSTD_INLINE uint64 _Match_Bytes(const unsigned char* p, const uint64& bits) noexcept {
+#if defined(SSTD_GROUP_AVX2)
+		__m256i pattern;
+		if constexpr (sizeof(_KeyT) == 1) {
+			pattern = _mm256_set1_epi8(static_cast<char>(bits));
+		}
+		else if constexpr (sizeof(_KeyT) == 2) {
+			pattern = _mm256_set1_epi16(static_cast<short>(bits));
+		}
+		else if constexpr (sizeof(_KeyT) == 4) {
+			pattern = _mm256_set1_epi32(static_cast<int>(bits));
+		}
+		else {
+			pattern = _mm256_set1_epi64x(static_cast<long long>(bits));
+		}
+		const __m256i keys = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+		return static_cast<uint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(keys, pattern)));
+#elif defined(SSTD_GROUP_SSE2)
+		__m128i pattern;
+		if constexpr (sizeof(_KeyT) == 1) {
+			pattern = _mm_set1_epi8(static_cast<char>(bits));
+		}
+		else if constexpr (sizeof(_KeyT) == 2) {
+			pattern = _mm_set1_epi16(static_cast<short>(bits));
+		}
+		else if constexpr (sizeof(_KeyT) == 4) {
+			pattern = _mm_set1_epi32(static_cast<int>(bits));
+		}
+		else {
+			pattern = _mm_set1_epi64x(static_cast<long long>(bits));
+		}
+		const __m128i keys = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		return static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(keys, pattern)));
+#else
+		// One uint64 at a time, a byte is equal if its xor is 0
+		uint64 word;
+		std::memcpy(&word, p, 8);
+		uint64 repeated = bits;
+		for (sizet i = sizeof(_KeyT); i < 8; i <<= 1) {
+			repeated |= repeated << (i * 8);
+		}
+		const uint64 diff = word ^ repeated;
+		uint64 res = 0;
+		for (sizet i = 0; i < 8; ++i) {
+			res |= uint64(((diff >> (i * 8)) & 0xff) == 0) << i;
+		}
+		return res;
+#endif
+	}
+
+	// Everything moves into a table with room for _size elements
+	SSTD_INLINE void _Spill(const sizet& _size) {
+		map_type* table = new map_type();
+		table->reserve(_size * 2);
+		for (sizet i = 0; i < m_count; ++i) {
+			table->try_emplace(std::move(_Key(i)), std::move(_Elt(i)));
+		}
+		_Destroy_Inline();
+		m_table = table;
+	}
+
+	SSTD_INLINE void _Destroy_Inline() noexcept {
+		for (sizet i = 0; i < m_count; ++i) {
+			_Key(i).~_KeyT();
+			_Elt(i).~_EltT();
+		}
+		m_count = 0;
+	}
+
+	template<typename _K, typename... _Args>
+	SSTD_INLINE std::pair<iterator, bool> _Try_Emplace(_K&& key, _Args&&... args) {
+		if (m_table == nullptr) {
+			const sizet ind = _Find_Inline(key);
+			if (ind != m_count) {
+				return { iterator(this, ind), false };
+			}
+			if (m_count < _N) {
+				new (&_Key(m_count)) _KeyT(std::forward<_K>(key));
+				new (&_Elt(m_count)) _EltT(std::forward<_Args>(args)...);
+				return { iterator(this, m_count++), true };
+			}
+			_Spill(_N + 1);
+		}
+		const std::pair<typename map_type::iterator, bool> res = m_table->try_emplace(std::forward<_K>(key), std::forward<_Args>(args)...);
+		return { iterator(this, res.first), res.second };
+	}
+
+	template<typename _K, typename _M>
+	SSTD_INLINE std::pair<iterator, bool> _Insert_Or_Assign(_K&& key, _M&& obj) {
+		if (m_table == nullptr) {
+			const sizet ind = _Find_Inline(key);
+			if (ind != m_count) {
+				_Elt(ind) = std::forward<_M>(obj);
+				return { iterator(this, ind), false };
+			}
+			if (m_count < _N) {
+				return _Try_Emplace(std::forward<_K>(key), std::forward<_M>(obj));
+			}
+			_Spill(_N + 1);
+		}
+		const std::pair<typename map_type::iterator, bool> res = m_table->insert_or_assign(std::forward<_K>(key), std::forward<_M>(obj));
+		return { iterator(this, res.first), res.second };
+	}
+
+	// Fill the hole with the last inline element
+	template<typename _K>
+	SSTD_INLINE void _Erase(const _K& key) {
+		if (m_table) {
+			m_table->erase(key);
+			return;
+		}
+		const sizet ind = _Find_Inline(key);
+		if (ind == m_count) {
+			return;
+		}
+		const sizet last = m_count - 1;
+		if (ind != last) {
+			_Key(ind) = std::move(_Key(last));
+			_Elt(ind) = std::move(_Elt(last));
+		}
+		_Key(last).~_KeyT();
+		_Elt(last).~_EltT();
+		--m_count;
+	}
+
+	template<typename _Iter, typename _Self, typename _K>
+	static SSTD_INLINE _Iter _Search(_Self* self, const _K& key) {
+		if (self->m_table) {
+			return _Iter(self, static_cast<typename std::conditional<std::is_const<_Self>::value, const map_type*, map_type*>::type>(self->m_table)->find(key));
+		}
+		return _Iter(self, self->_Find_Inline(key));
+	}
+
+	// The table, moving the inline elements there first if needed
+	SSTD_INLINE map_type& _Table() {
+		if (m_table == nullptr) {
+			_Spill(_N + 1);
+		}
+		return *m_table;
+	}
+
+	SSTD_INLINE void _Copy_From(const small_unordered_map& other) {
+		reserve(other.size());
+		for (const_iterator itr = other.begin(); itr != other.end(); ++itr) {
+			try_emplace(itr->first, itr->second);
+		}
+	}
+
+	// The table is stolen, inline elements are moved one by one
+	SSTD_INLINE void _Move_From(small_unordered_map&& other) {
+		if (other.m_table) {
+			m_table = other.m_table;
+			other.m_table = nullptr;
+			return;
+		}
+		for (sizet i = 0; i < other.m_count; ++i) {
+			new (&_Key(i)) _KeyT(std::move(other._Key(i)));
+			new (&_Elt(i)) _EltT(std::move(other._Elt(i)));
+		}
+		m_count = other.m_count;
+		other._Destroy_Inline();
+	}
+};
+
+// -----------------------------------------
+//
+//   Forward Iterator
+//
+// -----------------------------------------
+
+// An index into the inline arrays, or an iterator of the table once the map moved there
+
+template<
+	typename _KeyT,
+	typename _EltT,
+	sizet _N,
+	typename _Hash,
+	typename _ProbT
+>
+class _Small_Unordered_Map_Iterator : public forward_iterator<std::pair<_KeyT, _EltT> > {
+	friend class small_unordered_map<_KeyT, _EltT, _N, _Hash, _ProbT>;
+	friend class _Small_Unordered_Map_Const_Iterator<_KeyT, _EltT, _N, _Hash, _ProbT>;
+	using _Map = small_unordered_map<_KeyT, _EltT, _N, _Hash, _ProbT>;
+	using _Table_Iter = typename _Map::map_type::iterator;
+public:
+	using reference = std::pair<const _KeyT&, _EltT&>;
+	using pointer = _Arrow_Proxy<reference>;
+
+	_Small_Unordered_Map_Iterator(_Map* _map, sizet ind) :
+		m_map(_map), m_ind(ind), m_itr(nullptr, 0) {
+
+	}
+	_Small_Unordered_Map_Iterator(_Map* _map, _Table_Iter itr) :
+		m_map(_map), m_ind(0), m_itr(itr) {
+
+	}
+
+	SSTD_INLINE _Small_Unordered_Map_Iterator& operator++() noexcept {
+		if (m_map->m_table) {
+			++m_itr;
+		}
+		else {
+			++m_ind;
+		}
+		return *this;
+	}
+	SSTD_INLINE _Small_Unordered_Map_Iterator operator++(int) noexcept {
+		_Small_Unordered_Map_Iterator tmp = *this;
+		++*this;
+		return tmp;
+	}
+
+	SSTD_INLINE reference operator*() const noexcept {
+		if (m_map->m_table) {
+			return *m_itr;
+		}
+		return { m_map->_Key(m_ind), m_map->_Elt(m_ind) };
+	}
+	SSTD_INLINE pointer operator->() const noexcept {
+		return { **this };
+	}
+
+	SSTD_INLINE bool operator==(const _Small_Unordered_Map_Iterator& other) const noexcept {
+		return m_map == other.m_map && m_ind == other.m_ind && m_itr == other.m_itr;
+	}
+
+	SSTD_INLINE bool operator!=(const _Small_Unordered_Map_Iterator& other) const noexcept {
+		return !(*this == other);
+	}
+private:
+	_Map* m_map;
+	sizet m_ind;
+	_Table_Iter m_itr;
+};
+
+// -----------------------------------------
+//
+//   Const Forward Iterator
+//
+// -----------------------------------------
+
+template<
+	typename _KeyT,
+	typename _EltT,
+	sizet _N,
+	typename _Hash,
+	typename _ProbT
+>
+class _Small_Unordered_Map_Const_Iterator : public const_forward_iterator<std::pair<_KeyT, _EltT> > {
+	friend class small_unordered_map<_KeyT, _EltT, _N, _Hash, _ProbT>;
+	using _Map = small_unordered_map<_KeyT, _EltT, _N, _Hash, _ProbT>;
+	using _Table_Iter = typename _Map::map_type::const_iterator;
+public:
+	using reference = std::pair<const _KeyT&, const _EltT&>;
+	using pointer = _Arrow_Proxy<reference>;
+
+	_Small_Unordered_Map_Const_Iterator(const _Map* _map, sizet ind) :
+		m_map(_map), m_ind(ind), m_itr(nullptr, 0) {
+
+	}
+	_Small_Unordered_Map_Const_Iterator(const _Map* _map, _Table_Iter itr) :
+		m_map(_map), m_ind(0), m_itr(itr) {
+
+	}
+	_Small_Unordered_Map_Const_Iterator(_Small_Unordered_Map_Iterator<_KeyT, _EltT, _N, _Hash, _ProbT> itr) :
+		m_map(itr.m_map), m_ind(itr.m_ind), m_itr(itr.m_itr) {
+
+	}
+
+	SSTD_INLINE _Small_Unordered_Map_Const_Iterator& operator++() noexcept {
+		if (m_map->m_table) {
+			++m_itr;
+		}
+		else {
+			++m_ind;
+		}
+		return *this;
+	}
+	SSTD_INLINE _Small_Unordered_Map_Const_Iterator operator++(int) noexcept {
+		_Small_Unordered_Map_Const_Iterator tmp = *this;
+		++*this;
+		return tmp;
+	}
+
+	SSTD_INLINE reference operator*() const noexcept {
+		if (m_map->m_table) {
+			return *m_itr;
+		}
+		return { m_map->_Key(m_ind), m_map->_Elt(m_ind) };
+	}
+	SSTD_INLINE pointer operator->() const noexcept {
+		return { **this };
+	}
+
+	SSTD_INLINE bool operator==(const _Small_Unordered_Map_Const_Iterator& other) const noexcept {
+		return m_map == other.m_map && m_ind == other.m_ind && m_itr == other.m_itr;
+	}
+
+	SSTD_INLINE bool operator!=(const _Small_Unordered_Map_Const_Iterator& other) const noexcept {
+		return !(*this == other);
+	}
+private:
+	const _Map* m_map;
+	sizet m_ind;
+	_Table_Iter m_itr;
+};
+
+SSTD_END
+
+#endif
@@ -0,0 +1,422 @@
+#ifndef SSTD_SMALL_VECTOR_INCLUDED
+#define SSTD_SMALL_VECTOR_INCLUDED
+
+#include "core.hpp"
+#include "vector.hpp"
+
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+SSTD_BEGIN
+
+// sstd::vector with room for _Count objects inside the vector itself
+// Nothing is allocated until it grows past _Count, from there on it's a heap buffer that grows the way sstd::vector does
+// ( realloc for sstd::is_trivially_relocatable types, moving the objects one by one otherwise )
+// clear() goes back to the inline storage
+//
+// The elements are contiguous either way, so the iterators are plain pointers
+
+template<typename T, sizet _Count>
+class small_vector {
+	SSTD_STATIC_ASSERT(_Count > 0);
+public:
+	using iterator = T*;
+	using const_iterator = const T*;
+	using reverse_iterator = std::reverse_iterator<T*>;
+	using const_reverse_iterator = std::reverse_iterator<const T*>;
+
+public:
+
+	// Default Constructor
+	small_vector() SSTD_DEFAULT;
+
+	// Constructor that initialize 'length' amount of objects
+	SSTD_EXPLICIT small_vector(sizet length) {
+		_Grow(length);
+		_Fill_Range(0, length);
+		m_size = length;
+	}
+
+	// Constructor that set all the object to val
+	small_vector(sizet length, const T& val) {
+		_Grow(length);
+		_Fill_Range(0, length, val);
+		m_size = length;
+	}
+
+	// Constructor that initialize using a initializer list
+	small_vector(std::initializer_list<T> list) {
+		_Grow(list.size());
+		_Fill_Range_Iter(0, list.begin(), list.end());
+		m_size = list.size();
+	}
+
+	// Copy constructor, a single memcpy if T is trivially copyable
+	small_vector(const small_vector& other) {
+		_Grow(other.m_size);
+		_Copy_From(other);
+	}
+
+	// Move constructor, takes the buffer if it's on the heap, moves the objects if they're inline
+	small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+		_Take(other);
+	}
+
+	small_vector& operator=(const small_vector& other) {
+		if (this == &other) {
+			return *this;
+		}
+		_Destroy_All();
+		_Grow(other.m_size);
+		_Copy_From(other);
+		return *this;
+	}
+
+	small_vector& operator=(small_vector&& other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+		if (this != &other) {
+			clear();
+			_Take(other);
+		}
+		return *this;
+	}
+
+	// Destructor
+	~small_vector() {
+		_Destroy_All();
+		if (!is_inline()) {
+			free(m_data);
+		}
+	}
+
+	// Clear the vector. Aka call the destructor of every object, free the heap memory and go back to the inline storage
+	SSTD_INLINE void clear() noexcept {
+		_Destroy_All();
+		if (!is_inline()) {
+			free(m_data);
+			m_data = _Inline();
+			m_capacity = _Count;
+		}
+	}
+
+	// Construct the object to the back of the vector.
+	template<typename ... _Val>
+	SSTD_INLINE void emplace_back(_Val&& ...val) {
+		if (m_size >= m_capacity) {
+			_Grow(m_capacity * 2);
+		}
+		new (&m_data[m_size++]) T(std::forward<_Val>(val)...);
+	}
+
+	// Push val to the back of the vector
+	SSTD_INLINE void push_back(const T& val) {
+		emplace_back(val);
+	}
+	// Push val to the back of the vector
+	SSTD_INLINE void push_back(T&& val) {
+		emplace_back(std::forward<T>(val));
+	}
+
+	// Reserve a certain amount of memory ( without initialization ), on top of the capacity, same as sstd::vector
+	SSTD_INLINE void reserve(sizet new_cap) {
+		_Grow(m_capacity + new_cap);
+	}
+
+	// Resize the vector to new_size ( with initialization )
+	SSTD_INLINE void resize(sizet new_size) {
+		_Grow(new_size);
+		for (sizet i = new_size; i < m_size; ++i) {
+			m_data[i].~T();
+		}
+		_Fill_Range(m_size, new_size);
+		m_size = new_size;
+	}
+
+	// Insert the objects in the iterator to pos
+	template<typename _Iter>
+	SSTD_INLINE void insert(sizet pos, _Iter iter_beg, _Iter iter_end) {
+		_Insert_At(pos, iter_beg, iter_end);
+	}
+
+	// Insert the objects in the iterator to pos
+	template<typename _Iter>
+	SSTD_INLINE void insert(const_iterator pos, _Iter iter_beg, _Iter iter_end) {
+		_Insert_At(pos - m_data, iter_beg, iter_end);
+	}
+
+	// Insert the objects in the iterator to pos
+	template<typename _Iter>
+	SSTD_INLINE void insert(reverse_iterator pos, _Iter iter_beg, _Iter iter_end) {
+		_Insert_At(&*pos - m_data, iter_beg, iter_end);
+	}
+
+	// Insert the initializer_list in the iterator to pos
+	SSTD_INLINE void insert(sizet pos, std::initializer_list<T> _list) {
+		_Insert_At(pos, _list.begin(), _list.end());
+	}
+
+	// Insert the initializer_list in the iterator to pos
+	SSTD_INLINE void insert(const_iterator pos, std::initializer_list<T> _list) {
+		_Insert_At(pos - m_data, _list.begin(), _list.end());
+	}
+
+	// Insert the initializer_list in the iterator to pos
+	SSTD_INLINE void insert(reverse_iterator pos, std::initializer_list<T> _list) {
+		_Insert_At(&*pos - m_data, _list.begin(), _list.end());
+	}
+
+	SSTD_INLINE void erase(const sizet& pos) {
+		_Erase_Range(pos, pos + 1);
+	}
+	SSTD_INLINE void erase(const sizet& _start, const sizet& _end) {
+		_Erase_Range(_start, _end);
+	}
+	SSTD_INLINE void erase(const_iterator pos) {
+		_Erase_Range(pos - m_data, pos - m_data + 1);
+	}
+	SSTD_INLINE void erase(const_iterator _start, const_iterator _end) {
+		_Erase_Range(_start - m_data, _end - m_data);
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR sizet size() const noexcept {
+		return m_size;
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR sizet capacity() const noexcept {
+		return m_capacity;
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR bool empty() const noexcept {
+		return m_size == 0;
+	}
+
+	// Are the objects still in the inline storage
+	SSTD_INLINE bool is_inline() const noexcept {
+		return m_data == _Inline();
+	}
+
+	static SSTD_INLINE SSTD_CONSTEXPR sizet inline_capacity() noexcept {
+		return _Count;
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR T& front() noexcept {
+		return m_data[0];
+	}
+	SSTD_INLINE SSTD_CONSTEXPR T& back() noexcept {
+		return m_data[m_size - 1];
+	}
+	SSTD_INLINE SSTD_CONSTEXPR const T& front() const noexcept {
+		return m_data[0];
+	}
+	SSTD_INLINE SSTD_CONSTEXPR const T& back() const noexcept {
+		return m_data[m_size - 1];
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR T* data() noexcept {
+		return m_data;
+	}
+	SSTD_INLINE SSTD_CONSTEXPR const T* data() const noexcept {
+		return m_data;
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR T& at(const sizet& key) {
+		_Check_Range(key);
+		return m_data[key];
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR const T& at(const sizet& key) const {
+		_Check_Range(key);
+		return m_data[key];
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR T& operator[](sizet key) noexcept {
+		return m_data[key];
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR const T& operator[](sizet key) const noexcept {
+		return m_data[key];
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR iterator begin() noexcept {
+		return m_data;
+	}
+	SSTD_INLINE SSTD_CONSTEXPR iterator end() noexcept {
+		return m_data + m_size;
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR const_iterator begin() const noexcept {
+		return m_data;
+	}
+	SSTD_INLINE SSTD_CONSTEXPR const_iterator end() const noexcept {
+		return m_data + m_size;
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR reverse_iterator rbegin() noexcept {
+		return reverse_iterator(end());
+	}
+	SSTD_INLINE SSTD_CONSTEXPR reverse_iterator rend() noexcept {
+		return reverse_iterator(begin());
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR const_reverse_iterator rbegin() const noexcept {
+		return const_reverse_iterator(end());
+	}
+	SSTD_INLINE SSTD_CONSTEXPR const_reverse_iterator rend() const noexcept {
+		return const_reverse_iterator(begin());
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR const_iterator cbegin() const noexcept {
+		return begin();
+	}
+	SSTD_INLINE SSTD_CONSTEXPR const_iterator cend() const noexcept {
+		return end();
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR const_reverse_iterator crbegin() const noexcept {
+		return rbegin();
+	}
+	SSTD_INLINE SSTD_CONSTEXPR const_reverse_iterator crend() const noexcept {
+		return rend();
+	}
+private:
+	alignas(T) unsigned char m_inline[sizeof(T) * _Count];
+	T* m_data = _Inline();
+	sizet m_size = 0;
+	sizet m_capacity = _Count;
+
+	SSTD_INLINE T* _Inline() noexcept {
+		return reinterpret_cast<T*>(m_inline);
+	}
+	SSTD_INLINE const T* _Inline() const noexcept {
+		return reinterpret_cast<const T*>(m_inline);
+	}
+
+	// Make room for memsize objects, nothing happens if there already is
+	SSTD_INLINE void _Grow(sizet memsize) {
+		if (memsize <= m_capacity) {
+			return;
+		}
+		T* tmp = nullptr;
+		if (is_inline()) {
+			// Spill, the inline storage can't be realloc'd
+			tmp = (T*)malloc(sizeof(T) * memsize);
+			_Relocate<T>(tmp, m_data, m_size);
+		}
+		else if constexpr (is_trivially_relocatable<T>::value) {
+			tmp = (T*)realloc(static_cast<void*>(m_data), sizeof(T) * memsize);
+			// Handle situations if there aren't enough memory to extend
+			if (tmp == nullptr) {
+				tmp = (T*)malloc(sizeof(T) * memsize);
+				std::memcpy(static_cast<void*>(tmp), static_cast<const void*>(m_data), sizeof(T) * m_size);
+				free(m_data);
+			}
+		}
+		else {
+			tmp = (T*)malloc(sizeof(T) * memsize);
+			_Relocate<T>(tmp, m_data, m_size);
+			free(m_data);
+		}
+		m_data = tmp;
+		m_capacity = memsize;
+	}
+
+	SSTD_INLINE void _Destroy_All() noexcept {
+		for (sizet i = 0; i < m_size; ++i) {
+			m_data[i].~T();
+		}
+		m_size = 0;
+	}
+
+	// Take everything other has, this is empty and inline, other is left empty and inline
+	SSTD_INLINE void _Take(small_vector& other) {
+		if (other.is_inline()) {
+			_Relocate<T>(m_data, other.m_data, other.m_size);
+		}
+		else {
+			m_data = other.m_data;
+			m_capacity = other.m_capacity;
+			other.m_data = other._Inline();
+			other.m_capacity = _Count;
+		}
+		m_size = std::exchange(other.m_size, 0);
+	}
+
+	// Copy every object of other into the empty buffer, which has room for them
+	SSTD_INLINE void _Copy_From(const small_vector& other) {
+		if constexpr (std::is_trivially_copyable<T>::value) {
+			if (other.m_size) {
+				std::memcpy(m_data, other.m_data, sizeof(T) * other.m_size);
+			}
+		}
+		else {
+			for (sizet i = 0; i < other.m_size; ++i) {
+				new (m_data + i) T(other.m_data[i]);
+			}
+		}
+		m_size = other.m_size;
+	}
+
+	SSTD_INLINE void _Fill_Range(sizet start, sizet end) {
+		for (; start < end; ++start) {
+			new (&m_data[start]) T();
+		}
+	}
+
+	SSTD_INLINE void _Fill_Range(sizet start, sizet end, const T& val) {
+		for (; start < end; ++start) {
+			new (&m_data[start]) T(val);
+		}
+	}
+
+	template<typename _Iter>
+	SSTD_INLINE void _Fill_Range_Iter(sizet pos, _Iter _Start, _Iter _End) {
+		for (; _Start != _End; ++pos, ++_Start) {
+			new (&m_data[pos]) T(*_Start);
+		}
+	}
+
+	// Make a gap at pos, then fill in the iterator
+	template<typename _Iter>
+	SSTD_INLINE void _Insert_At(sizet pos, _Iter iter_beg, _Iter iter_end) {
+		const sizet Dis = std::distance(iter_beg, iter_end);
+		if (pos > m_size) {
+			// completly out side the 'insertable range'
+			throw std::out_of_range("Invalid insert position");
+		}
+		if (Dis == 0) {
+			return;
+		}
+		if (m_size + Dis > m_capacity) {
+			_Grow(m_size + Dis > m_capacity * 2 ? m_size + Dis : m_capacity * 2);
+		}
+		_Relocate<T>(m_data + pos + Dis, m_data + pos, m_size - pos);
+		_Fill_Range_Iter(pos, iter_beg, iter_end);
+		m_size += Dis;
+	}
+
+	SSTD_INLINE void _Erase_Range(const sizet& _start, const sizet& _end) {
+		if (_start == _end) {
+			return;
+		}
+		for (sizet i = _start; i < _end; ++i) {
+			m_data[i].~T();
+		}
+		// Close the gap
+		_Relocate_Left<T>(m_data + _start, m_data + _end, m_size - _end);
+		m_size -= _end - _start;
+	}
+
+	SSTD_INLINE void _Check_Range(const sizet& ind) const {
+		if (ind >= m_size) {
+			throw std::out_of_range("Vector subscript out of range");
+		}
+	}
+};
+
+SSTD_END
+
+#endif
@@ -1,16 +1,35 @@
 #include<iostream>
+#include<algorithm>
 #include<vector>
 #include<unordered_map>
+#include<unordered_set>
+#include<list>
+#include<map>
 #include<chrono>
+#include<thread>
+#include<atomic>
+#include<shared_mutex>
+#include<mutex>
+#include<sstream>
 #include "vector.hpp"
+#include "small_vector.hpp"
 #include "Array.hpp"
-#include "Debug/Time.hpp"
-#include "Debug/Debug.hpp"
 #include "unordered_map.hpp"
+#include "read_mostly_unordered_map.hpp"
+#include "concurrent_unordered_map.hpp"
+#include "small_unordered_map.hpp"
+#include "mapped_unordered_map.hpp"
+#include "unordered_set.hpp"
+#include "parallel_aggregate.hpp"
+#include "cuckoo_map.hpp"
+#include "frozen_map.hpp"
+#include "lru_cache.hpp"
+#include "persistent_map.hpp"
+#include <string>
 
 // This is really just for testing
 
-#define initTimeFunc() sstd::Clock _Clock_To_Time_Things
+#define initTimeFunc() Clock _Clock_To_Time_Things
 #define timeFunc(varname, func) func auto varname = _Clock_To_Time_Things.End().asMilli
 
 using std::chrono::high_resolution_clock;
@@ -18,9 +37,44 @@ using std::chrono::duration_cast;
 using std::chrono::duration;
 using std::chrono::milliseconds;
 using sstd::Decimal;
-using sstd::print;
 using sstd::sizet;
 
+// Every argument, then a newline
+void print() {
+	std::cout << std::endl;
+}
+template<typename T, typename... _Rest>
+void print(const T& first, const _Rest&... rest) {
+	std::cout << first;
+	print(rest...);
+}
+
+// Milliseconds since the last End() ( or since it got made )
+struct Clock {
+	struct Elapsed {
+		Decimal asMilli;
+	};
+	high_resolution_clock::time_point start = high_resolution_clock::now();
+
+	Elapsed End() {
+		const high_resolution_clock::time_point now = high_resolution_clock::now();
+		const Elapsed res{ duration<Decimal, std::milli>(now - start).count() };
+		start = now;
+		return res;
+	}
+};
+
+// Same numbers every run, so a failing step can be replayed
+struct test_random {
+	unsigned seed;
+
+	// Something in [0, bound)
+	sizet operator()(const sizet bound) {
+		seed = seed * 1103515245 + 12345;
+		return static_cast<sizet>((seed >> 8) % bound);
+	}
+};
+
 struct v {
 	int x, y;
 	v() = default;
@@ -125,6 +179,1033 @@ void test_vector() {
 		print("		std::vector		clear:			", std_clear, " ms");
 	}*/
 }
+// Knows when it got moved by memmove, or moved onto itself and destroyed
+struct self_ref {
+	self_ref* self;
+	int val;
+	self_ref(int i = 0) :self(this), val(i) {}
+	self_ref(const self_ref& o) :self(this), val(o.val) {}
+	self_ref& operator=(const self_ref& o) {
+		val = o.val;
+		return *this;
+	}
+	~self_ref() {
+		self = nullptr;
+	}
+	bool ok() const {
+		return self == this;
+	}
+};
+
+// Empty insert / erase ranges used to move every object after pos onto itself
+void test_vector_empty_ranges() {
+	sstd::vector<std::string> strs({ "a", "a string too long for the small string buffer", "c" });
+	sstd::vector<std::string> none;
+	strs.erase(strs.begin() + 1, strs.begin() + 1);
+	strs.insert(1, none.begin(), none.end());
+	strs.insert(3, {});
+	SSTD_ASSERT(strs.size() == 3 && strs[1] == "a string too long for the small string buffer" && strs[2] == "c");
+
+	sstd::vector<self_ref> refs({ 1, 2, 3, 4 });
+	refs.erase(refs.begin(), refs.begin());
+	refs.erase(refs.begin() + 2, refs.begin() + 2);
+	refs.insert(2, {});
+	refs.erase(refs.begin() + 1, refs.begin() + 3);
+	refs.insert(1, { 5, 6 });
+	const int expected[] = { 1, 5, 6, 4 };
+	SSTD_ASSERT(refs.size() == 4);
+	for (sizet i = 0; i < refs.size(); ++i) {
+		SSTD_ASSERT(refs[i].ok() && refs[i].val == expected[i]);
+	}
+	print("sstd::vector empty ranges: ok\n");
+}
+// Random inserts / erases ( empty ranges included ) against std::vector, across the inline / heap boundary
+void test_small_vector() {
+	sstd::small_vector<self_ref, 4> small;
+	std::vector<int> expected;
+	unsigned seed = 12345;
+	const auto next = [&seed](const sizet bound) {
+		seed = seed * 1103515245 + 12345;
+		return static_cast<sizet>((seed >> 8) % bound);
+	};
+	bool spilled = false;
+	for (int step = 0; step < 20000; ++step) {
+		const sizet pos = next(expected.size() + 1);
+		switch (next(5)) {
+		case 0: {
+			const sizet count = next(4);
+			std::vector<self_ref> vals;
+			for (sizet i = 0; i < count; ++i) {
+				vals.emplace_back(step);
+			}
+			small.insert(pos, vals.begin(), vals.end());
+			expected.insert(expected.begin() + pos, count, step);
+			break;
+		}
+		case 1: {
+			const sizet end = pos + next(expected.size() - pos + 1);
+			small.erase(pos, end);
+			expected.erase(expected.begin() + pos, expected.begin() + end);
+			break;
+		}
+		case 2:
+			small.emplace_back(step);
+			expected.push_back(step);
+			break;
+		case 3:
+			if (expected.size() > 8) {
+				small.clear();
+				expected.clear();
+			}
+			break;
+		default: {
+			sstd::small_vector<self_ref, 4> moved(std::move(small));
+			small = moved;
+			break;
+		}
+		}
+		spilled |= !small.is_inline();
+		SSTD_ASSERT(small.size() == expected.size());
+		SSTD_ASSERT(small.is_inline() == (small.capacity() == small.inline_capacity()));
+		for (sizet i = 0; i < expected.size(); ++i) {
+			SSTD_ASSERT(small[i].ok() && small[i].val == expected[i]);
+		}
+	}
+	SSTD_ASSERT(spilled);
+	print("sstd::small_vector against std::vector: ok\n");
+}
+// Random inserts / erases / lookups on map and on a std::unordered_map, checked against each other after every step
+// make_key(i) is the i-th key out of key_range, make_elt(i) an element, both need to give equal results for equal i
+// Once the steps are done, iterating map has to give every key of the std::unordered_map exactly once
+template<typename _KeyT, typename _EltT, typename _Map, typename _MakeKey, typename _MakeElt>
+void check_map_against_std(_Map& map, _MakeKey make_key, _MakeElt make_elt, const sizet key_range, const int steps, const unsigned seed) {
+	std::unordered_map<_KeyT, _EltT> expected;
+	test_random next{ seed };
+	for (int step = 0; step < steps; ++step) {
+		const _KeyT key = make_key(next(key_range));
+		const _EltT elt = make_elt(step);
+		const bool exists = expected.find(key) != expected.end();
+		switch (next(6)) {
+		case 0:
+			map.insert(key, elt);
+			expected[key] = elt;
+			break;
+		case 1:
+			// Leaves Deleted slots behind, the other cases have to probe past them
+			map.erase(key);
+			expected.erase(key);
+			break;
+		case 2:
+			map[key] = elt;
+			expected[key] = elt;
+			break;
+		case 3:
+			SSTD_ASSERT(map.try_emplace(key, elt).second == !exists);
+			expected.emplace(key, elt);
+			break;
+		case 4:
+			SSTD_ASSERT(map.insert_or_assign(key, elt).second == !exists);
+			expected[key] = elt;
+			break;
+		default: {
+			const auto itr = map.find(key);
+			SSTD_ASSERT((itr != map.end()) == exists && map.contains(key) == exists);
+			SSTD_ASSERT(!exists || itr->second == expected[key]);
+			break;
+		}
+		}
+		SSTD_ASSERT(map.size() == expected.size());
+	}
+	sizet seen = 0;
+	for (auto itr = map.begin(); itr != map.end(); ++itr) {
+		const auto ref = expected.find(itr->first);
+		SSTD_ASSERT(ref != expected.end() && itr->second == ref->second);
+		++seen;
+	}
+	SSTD_ASSERT(seen == expected.size());
+}
+
+// Control byte groups, with lots of Deleted slots and keys that share their control byte
+void test_unordered_map_against_std() {
+	sstd::unordered_map<int, int> ints;
+	check_map_against_std<int, int>(ints, [](sizet i) { return static_cast<int>(i); }, [](int i) { return i; }, 5000, 100000, 1);
+	sstd::unordered_map<std::string, int> strs;
+	check_map_against_std<std::string, int>(strs, [](sizet i) { return "key " + std::to_string(i); }, [](int i) { return i; }, 3000, 60000, 2);
+
+	// Every key erased, nothing is left to find
+	std::vector<int> keys;
+	for (auto itr = ints.begin(); itr != ints.end(); ++itr) {
+		keys.push_back(itr->first);
+	}
+	for (int key : keys) {
+		ints.erase(key);
+	}
+	SSTD_ASSERT(ints.empty() && ints.begin() == ints.end() && !ints.contains(keys.empty() ? 0 : keys[0]));
+	print("sstd::unordered_map against std::unordered_map: ok\n");
+}
+// Robin Hood never leaves a Deleted slot, erasing shifts the rest of the run back instead
+void test_robin_hood_map() {
+	using robin_hood_map = sstd::unordered_map<int, int, sstd::_Default_Hash<int>, sstd::_Robin_Hood_Prob<int, sstd::_Default_Hash<int> > >;
+	robin_hood_map map;
+	check_map_against_std<int, int>(map, [](sizet i) { return static_cast<int>(i); }, [](int i) { return i; }, 5000, 100000, 3);
+	SSTD_ASSERT(map.tombstones() == 0);
+
+	// Long runs, every other key of a full table goes and the rest still has to be found
+	robin_hood_map full;
+	for (int i = 0; i < 20000; ++i) {
+		full[i] = i;
+	}
+	for (int i = 0; i < 20000; i += 2) {
+		full.erase(i);
+	}
+	SSTD_ASSERT(full.size() == 10000 && full.tombstones() == 0);
+	for (int i = 0; i < 20000; ++i) {
+		SSTD_ASSERT(full.contains(i) == (i % 2 == 1));
+	}
+	print("sstd::unordered_map with Robin Hood probing: ok\n");
+}
+// Every operation has to look in both tables while the old one is still being moved over
+void test_incremental_rehash() {
+	sstd::unordered_map<int, int> grown;
+	grown.set_rehash_step(1);
+	bool seen_rehashing = false;
+	for (int i = 0; i < 20000; ++i) {
+		grown[i] = i;
+		seen_rehashing |= grown.rehashing();
+		if (grown.rehashing()) {
+			// Keys from before the grow are still found, wherever they are
+			SSTD_ASSERT(grown.contains(i / 2) && grown.find(i / 3)->second == i / 3);
+		}
+	}
+	SSTD_ASSERT(seen_rehashing);
+
+	sstd::unordered_map<int, int> map;
+	map.set_rehash_step(1);
+	check_map_against_std<int, int>(map, [](sizet i) { return static_cast<int>(i); }, [](int i) { return i; }, 40000, 100000, 4);
+	print("sstd::unordered_map with incremental rehash: ok\n");
+}
+// Counts every call, to check that growing a table with cached hashes never hashes again
+struct counting_string_hash : sstd::_Default_Hash<std::string> {
+	static inline sizet calls = 0;
+	sizet operator()(const std::string& key) const {
+		++calls;
+		return sstd::_Default_Hash<std::string>::operator()(key);
+	}
+};
+void test_cached_hash() {
+	SSTD_STATIC_ASSERT(sstd::is_hash_expensive<std::string>::value && !sstd::is_hash_expensive<int>::value);
+	sstd::unordered_map<std::string, int, counting_string_hash, sstd::_Double_Hash_Prob<std::string, counting_string_hash> > map;
+	const sizet start_capacity = map.capacity();
+	for (int i = 0; i < 10000; ++i) {
+		map.insert("key " + std::to_string(i), i);
+	}
+	// One hash per insert, however many times the table grew
+	SSTD_ASSERT(map.capacity() > start_capacity && counting_string_hash::calls == 10000);
+	map.clear();
+	check_map_against_std<std::string, int>(map, [](sizet i) { return "key " + std::to_string(i); }, [](int i) { return i; }, 20000, 60000, 5);
+	print("sstd::unordered_map with cached hashes: ok\n");
+}
+// Elements of a cache line or more live in their own array, next to the keys
+struct big_elt {
+	int value = 0;
+	char padding[124] = {};
+
+	big_elt() = default;
+	big_elt(int _value) : value(_value) {}
+	bool operator==(const big_elt& other) const {
+		return value == other.value;
+	}
+};
+void test_split_storage() {
+	SSTD_STATIC_ASSERT(sstd::is_split_storage<int, big_elt>::value && !sstd::is_split_storage<int, int>::value);
+	sstd::unordered_map<int, big_elt> map;
+	check_map_against_std<int, big_elt>(map, [](sizet i) { return static_cast<int>(i); }, [](int i) { return big_elt(i); }, 3000, 60000, 6);
+
+	sstd::unordered_map<int, big_elt> rehashed;
+	rehashed.set_rehash_step(1);
+	check_map_against_std<int, big_elt>(rehashed, [](sizet i) { return static_cast<int>(i); }, [](int i) { return big_elt(i); }, 3000, 60000, 7);
+	print("sstd::unordered_map with split storage: ok\n");
+}
+// string_view and const char* find the std::string keys without building one
+void test_transparent_lookup() {
+	sstd::unordered_map<std::string, int> map;
+	for (int i = 0; i < 1000; ++i) {
+		map.insert("key " + std::to_string(i), i);
+	}
+	for (int i = 0; i < 1000; ++i) {
+		const std::string key = "key " + std::to_string(i);
+		const std::string_view view = key;
+		SSTD_ASSERT(map.contains(view) && map.find(view)->second == i && map.contains(key.c_str()));
+		SSTD_ASSERT(!map.contains(std::string_view("missing " + key)));
+	}
+	SSTD_ASSERT(map.find(std::string_view("key 1000")) == map.end());
+	map.erase(std::string_view("key 10"));
+	map.erase("key 11");
+	SSTD_ASSERT(map.size() == 998 && !map.contains("key 10") && !map.contains(std::string_view("key 11")) && map.contains("key 12"));
+
+	const std::string_view views[] = { "key 1", "key 10", "key 999", "nope" };
+	const int* found[4] = {};
+	const sstd::unordered_map<std::string, int>& const_map = map;
+	SSTD_ASSERT(const_map.find_batch(views, 4, found) == 2);
+	SSTD_ASSERT(found[0] && *found[0] == 1 && !found[1] && found[2] && *found[2] == 999 && !found[3]);
+	print("sstd::unordered_map transparent lookup: ok\n");
+}
+// Sharded map, against std on one thread and counted with several
+void test_concurrent_unordered_map_against_std() {
+	sstd::concurrent_unordered_map<int, int> map;
+	std::unordered_map<int, int> expected;
+	test_random next{ 8 };
+	for (int step = 0; step < 60000; ++step) {
+		const int key = static_cast<int>(next(3000));
+		switch (next(4)) {
+		case 0:
+			map.insert(key, step);
+			expected[key] = step;
+			break;
+		case 1:
+			map.erase(key);
+			expected.erase(key);
+			break;
+		case 2:
+			map.update(key, [&](int& elt) { elt += step; });
+			expected[key] += step;
+			break;
+		default: {
+			int found = -1;
+			const bool exists = expected.find(key) != expected.end();
+			SSTD_ASSERT(map.find(key, found) == exists && map.contains(key) == exists);
+			SSTD_ASSERT(!exists || found == expected[key]);
+			break;
+		}
+		}
+	}
+	SSTD_ASSERT(map.size() == expected.size());
+	map.for_each_shard([&](const sstd::unordered_map<int, int>& shard) {
+		for (auto itr = shard.begin(); itr != shard.end(); ++itr) {
+			SSTD_ASSERT(expected.at(itr->first) == itr->second);
+		}
+	});
+
+	// Every thread bumps the same keys, no update gets lost
+	sstd::concurrent_unordered_map<int, int> counts;
+	const int threads = 4, per_thread = 20000;
+	std::vector<std::thread> workers;
+	for (int t = 0; t < threads; ++t) {
+		workers.emplace_back([&, t]() {
+			for (int i = 0; i < per_thread; ++i) {
+				counts.update(i % 100, [](int& elt) { ++elt; });
+				counts.insert(100000 * (t + 1) + i, i);
+			}
+		});
+	}
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	SSTD_ASSERT(counts.size() == 100 + threads * per_thread);
+	for (int key = 0; key < 100; ++key) {
+		int found = 0;
+		SSTD_ASSERT(counts.find(key, found) && found == threads * per_thread / 100);
+	}
+	print("sstd::concurrent_unordered_map against std::unordered_map: ok\n");
+}
+// Batches give the same answers as one call per key, including batches shorter / longer than the prefetch window
+void test_batch_operations() {
+	sstd::unordered_map<int, int> batched, single;
+	std::vector<int> keys, elts;
+	test_random next{ 9 };
+	for (int i = 0; i < 5000; ++i) {
+		keys.push_back(static_cast<int>(next(8000)));
+		elts.push_back(i);
+	}
+	for (sizet n : { sizet(0), sizet(1), sizet(3), sizet(17), keys.size() }) {
+		batched.clear();
+		single.clear();
+		batched.insert_batch(keys.data(), elts.data(), n);
+		for (sizet i = 0; i < n; ++i) {
+			single.insert(keys[i], elts[i]);
+		}
+		SSTD_ASSERT(batched.size() == single.size());
+
+		// Every key in the range, hits and misses
+		std::vector<int> lookups(8000);
+		std::vector<int*> found(lookups.size());
+		sizet hits = 0;
+		for (int key = 0; key < 8000; ++key) {
+			lookups[key] = key;
+			hits += single.contains(key);
+		}
+		SSTD_ASSERT(batched.find_batch(lookups.data(), lookups.size(), found.data()) == hits);
+		for (int key = 0; key < 8000; ++key) {
+			const auto itr = single.find(key);
+			SSTD_ASSERT((found[key] != nullptr) == (itr != single.end()));
+			SSTD_ASSERT(found[key] == nullptr || *found[key] == itr->second);
+		}
+	}
+	print("sstd::unordered_map batch operations: ok\n");
+}
+// Seeded hashers: same seed same hash, and the keys that compare equal hash equal
+void test_hash_functions() {
+	const sstd::_Default_Hash<int> a(1), b(1), c(2);
+	SSTD_ASSERT(a(12345) == b(12345) && a(12345) != c(12345));
+	SSTD_ASSERT(sstd::_Default_Hash<int>()(7) == sstd::_Default_Hash<int>()(7));
+
+	const sstd::_Default_Hash<double> floats(3);
+	SSTD_ASSERT(floats(0.0) == floats(-0.0) && floats(1.5) != floats(-1.5));
+
+	const sstd::_Default_Hash<std::string> strs(4);
+	const std::string text = "the quick brown fox";
+	SSTD_ASSERT(strs(text) == strs(std::string_view(text)) && strs(text) == sstd::_Default_Hash<std::string_view>(4)(text));
+	SSTD_ASSERT(strs(text) != sstd::_Default_Hash<std::string>(5)(text) && strs(text) != strs(text + "!"));
+	// Past the short path, every byte still counts
+	std::string long_text(5000, 'x');
+	const sizet long_hash = strs(long_text);
+	SSTD_ASSERT(long_hash == strs(std::string(5000, 'x')));
+	long_text[4321] = 'y';
+	SSTD_ASSERT(long_hash != strs(long_text));
+
+	// Sequential keys spread over the low bits, which is all a small table reads
+	bool seen[64] = {};
+	sizet buckets = 0;
+	for (int i = 0; i < 256; ++i) {
+		const sizet bucket = a(i) & 63;
+		buckets += !seen[bucket];
+		seen[bucket] = true;
+	}
+	SSTD_ASSERT(buckets > 48);
+	print("sstd hash functions: ok\n");
+}
+// fastrange reduction, the capacity is whatever was asked for instead of the next power of 2
+template<template<typename, typename, typename> class _Prob>
+void check_fastrange_map(const unsigned seed) {
+	using hash_type = sstd::_Default_Hash<int>;
+	sstd::unordered_map<int, int, hash_type, _Prob<int, hash_type, sstd::_Fastrange_Reduce> > map;
+	check_map_against_std<int, int>(map, [](sizet i) { return static_cast<int>(i); }, [](int i) { return i; }, 5000, 60000, seed);
+}
+template<typename T, typename _Hash, typename _Reduce>
+using quadratic_prob = sstd::_Quadratic_Prob2<T, 0, 1, _Hash, _Reduce>;
+void test_fastrange_reduce() {
+	using fastrange_map = sstd::unordered_map<int, int, sstd::_Default_Hash<int>, sstd::_Linear_Prob<int, sstd::_Default_Hash<int>, sstd::_Fastrange_Reduce> >;
+	using mask_map = sstd::unordered_map<int, int>;
+	SSTD_ASSERT(fastrange_map::slot_capacity(100) == 100 && mask_map::slot_capacity(100) == 128);
+	for (sizet x : { sizet(0), sizet(1), ~sizet(0), sizet(0x0123456789abcdefull) }) {
+		SSTD_ASSERT(sstd::_Fastrange_Reduce::reduce(x, 100) < 100 && sstd::_Fastrange_Reduce::wrap(99, x, 100) < 100);
+	}
+	fastrange_map reserved;
+	reserved.reserve(1000);
+	SSTD_ASSERT((reserved.capacity() & (reserved.capacity() - 1)) != 0);
+	check_fastrange_map<sstd::_Linear_Prob>(10);
+	check_fastrange_map<quadratic_prob>(11);
+	check_fastrange_map<sstd::_Double_Hash_Prob>(12);
+	print("sstd::unordered_map with fastrange reduction: ok\n");
+}
+// try_emplace / insert_or_assign / emplace, and none of them grows the table for a key that's already there
+void test_emplace_operations() {
+	sstd::unordered_map<std::string, std::string> map;
+	std::string key = "key", elt = "elt";
+	SSTD_ASSERT(map.try_emplace(std::move(key), std::move(elt)).second && map["key"] == "elt");
+	// The key exists, nothing gets moved from
+	key = "key";
+	elt = "other";
+	const auto res = map.try_emplace(std::move(key), std::move(elt));
+	SSTD_ASSERT(!res.second && res.first->second == "elt" && key == "key" && elt == "other");
+
+	SSTD_ASSERT(!map.insert_or_assign("key", std::string("assigned")).second && map["key"] == "assigned");
+	SSTD_ASSERT(map.insert_or_assign("new", std::string("inserted")).second && map["new"] == "inserted");
+	SSTD_ASSERT(map.emplace(std::piecewise_construct, std::forward_as_tuple(3, 'a'), std::forward_as_tuple("built")).second);
+	SSTD_ASSERT(map["aaa"] == "built" && !map.emplace(std::string("aaa"), std::string("again")).second && map["aaa"] == "built");
+
+	// Fill the table right up to where the next new key grows it
+	sstd::unordered_map<int, int> full;
+	int fits = 0;
+	for (sstd::unordered_map<int, int> probe; ; ++fits) {
+		const sizet capacity = probe.capacity();
+		probe[fits] = fits;
+		if (fits > 0 && probe.capacity() != capacity) {
+			break;
+		}
+	}
+	for (int i = 0; i < fits; ++i) {
+		full[i] = i;
+	}
+	const sizet capacity = full.capacity();
+	int& first = full[0];
+	for (int i = 0; i < fits; ++i) {
+		++full[i];
+		full.try_emplace(i, 0);
+		full.insert_or_assign(i, full[i] + 1);
+	}
+	SSTD_ASSERT(full.capacity() == capacity && &full[0] == &first && first == 2);
+	print("sstd::unordered_map emplace operations: ok\n");
+}
+// Inline while it fits, in a table once it doesn't
+void test_small_unordered_map() {
+	sstd::small_unordered_map<int, int> map;
+	// Never more than 8 keys, it never leaves the object
+	check_map_against_std<int, int>(map, [](sizet i) { return static_cast<int>(i); }, [](int i) { return i; }, 8, 20000, 13);
+	SSTD_ASSERT(map.is_inline());
+	map.clear();
+	check_map_against_std<int, int>(map, [](sizet i) { return static_cast<int>(i); }, [](int i) { return i; }, 200, 20000, 14);
+	SSTD_ASSERT(!map.is_inline());
+	map.clear();
+	SSTD_ASSERT(map.is_inline() && map.empty());
+
+	// Keys that can't be compared byte by byte
+	sstd::small_unordered_map<std::string, int, 4> strs;
+	check_map_against_std<std::string, int>(strs, [](sizet i) { return "key " + std::to_string(i); }, [](int i) { return i; }, 4, 10000, 15);
+	SSTD_ASSERT(strs.is_inline());
+	sstd::small_unordered_map<std::string, int, 4> copy = strs, moved = std::move(copy);
+	SSTD_ASSERT(moved.size() == strs.size());
+	for (auto itr = strs.begin(); itr != strs.end(); ++itr) {
+		SSTD_ASSERT(moved.find(itr->first)->second == itr->second);
+	}
+	strs.clear();
+	check_map_against_std<std::string, int>(strs, [](sizet i) { return "key " + std::to_string(i); }, [](int i) { return i; }, 100, 10000, 16);
+	print("sstd::small_unordered_map against std::unordered_map: ok\n");
+}
+// Saved tables are read back through a mapping, and only by a map of the same type
+void test_mapped_unordered_map() {
+	const char* path = "sstd_test_map.bin";
+	sstd::unordered_map<int, double> map;
+	for (int i = 0; i < 10000; ++i) {
+		map[i * 7] = i * 0.5;
+	}
+	for (int i = 0; i < 10000; i += 3) {
+		map.erase(i * 7);
+	}
+	map.save(path);
+	{
+		const auto mapped = sstd::unordered_map<int, double>::open_mapped(path);
+		SSTD_ASSERT(mapped.size() == map.size());
+		for (int i = 0; i < 70000; ++i) {
+			const auto itr = map.find(i);
+			const auto mapped_itr = mapped.find(i);
+			SSTD_ASSERT((itr == map.end()) == (mapped_itr == mapped.end()));
+			SSTD_ASSERT(itr == map.end() || itr->second == mapped_itr->second);
+		}
+		sizet seen = 0;
+		for (auto itr = mapped.begin(); itr != mapped.end(); ++itr) {
+			SSTD_ASSERT(map.find(itr->first)->second == itr->second);
+			++seen;
+		}
+		SSTD_ASSERT(seen == map.size());
+	}
+
+	// Another element type, or another probing, doesn't get to read it
+	bool threw = false;
+	try {
+		sstd::unordered_map<int, int>::open_mapped(path);
+	}
+	catch (const std::runtime_error&) {
+		threw = true;
+	}
+	SSTD_ASSERT(threw);
+	threw = false;
+	try {
+		sstd::unordered_map<int, double, sstd::_Default_Hash<int>, sstd::_Linear_Prob<int, sstd::_Default_Hash<int> > >::open_mapped(path);
+	}
+	catch (const std::runtime_error&) {
+		threw = true;
+	}
+	SSTD_ASSERT(threw);
+	std::remove(path);
+	print("sstd::mapped_unordered_map: ok\n");
+}
+// The counters only exist with SSTD_MAP_STATS defined
+void test_map_stats() {
+#if defined(SSTD_MAP_STATS)
+	sstd::unordered_map<int, int> map;
+	for (int i = 0; i < 5000; ++i) {
+		map[i] = i;
+	}
+	for (int i = 0; i < 5000; i += 2) {
+		map.erase(i);
+	}
+	map.reset_stats();
+	for (int i = 0; i < 5000; ++i) {
+		map.contains(i);
+	}
+	const sstd::unordered_map_stats res = map.stats();
+	sstd::uint64 hits = 0, misses = 0;
+	for (sizet i = 0; i < sstd::unordered_map_stats::buckets; ++i) {
+		hits += res.hit_probes[i];
+		misses += res.miss_probes[i];
+	}
+	SSTD_ASSERT(hits == 2500 && misses == 2500 && res.growths == 0 && res.tombstones == map.tombstones());
+
+	sstd::unordered_map<int, int> grown;
+	for (int i = 0; i < 5000; ++i) {
+		grown[i] = i;
+	}
+	SSTD_ASSERT(grown.stats().growths > 0 && grown.stats().tombstones == 0);
+	std::ostringstream dump;
+	grown.debug_dump(dump, 4);
+	SSTD_ASSERT(dump.str().find("size 5000") == 0);
+	print("sstd::unordered_map stats: ok\n");
+#else
+	print("sstd::unordered_map stats: skipped, SSTD_MAP_STATS isn't defined\n");
+#endif
+}
+// Every key of set is in expected and the other way around
+template<typename _Set, typename _KeyT>
+void check_set_equals(const _Set& set, const std::unordered_set<_KeyT>& expected) {
+	SSTD_ASSERT(set.size() == expected.size());
+	for (auto itr = set.begin(); itr != set.end(); ++itr) {
+		SSTD_ASSERT(expected.count(*itr) == 1);
+	}
+	for (const _KeyT& key : expected) {
+		SSTD_ASSERT(set.contains(key));
+	}
+}
+// Random inserts / erases, then merge / intersect_with / contains_all against the same on std sets
+template<typename _Set, typename _KeyT, typename _MakeKey>
+void check_set_against_std(_MakeKey make_key, const sizet step, const unsigned seed) {
+	_Set a, b;
+	a.set_rehash_step(step);
+	b.set_rehash_step(step);
+	std::unordered_set<_KeyT> expected_a, expected_b;
+	test_random next{ seed };
+	for (int i = 0; i < 20000; ++i) {
+		const _KeyT key = make_key(next(4000));
+		_Set& set = next(2) ? a : b;
+		std::unordered_set<_KeyT>& expected = &set == &a ? expected_a : expected_b;
+		if (next(3)) {
+			SSTD_ASSERT(set.insert(key).second == expected.insert(key).second);
+		}
+		else {
+			set.erase(key);
+			expected.erase(key);
+		}
+	}
+	check_set_equals(a, expected_a);
+	check_set_equals(b, expected_b);
+
+	_Set merged = a, intersected = a;
+	merged.merge(b);
+	intersected.intersect_with(b);
+	std::unordered_set<_KeyT> expected_merged = expected_a, expected_intersected;
+	for (const _KeyT& key : expected_b) {
+		expected_merged.insert(key);
+		if (expected_a.count(key)) {
+			expected_intersected.insert(key);
+		}
+	}
+	check_set_equals(merged, expected_merged);
+	check_set_equals(intersected, expected_intersected);
+	SSTD_ASSERT(merged.contains_all(a) && merged.contains_all(b) && a.contains_all(intersected) && b.contains_all(intersected));
+	SSTD_ASSERT(a.contains_all(b) == (expected_intersected.size() == expected_b.size()));
+}
+void test_unordered_set() {
+	using robin_hood_set = sstd::unordered_set<int, sstd::_Default_Hash<int>, sstd::_Robin_Hood_Prob<int, sstd::_Default_Hash<int> > >;
+	check_set_against_std<sstd::unordered_set<int>, int>([](sizet i) { return static_cast<int>(i); }, 0, 17);
+	check_set_against_std<sstd::unordered_set<int>, int>([](sizet i) { return static_cast<int>(i); }, 1, 18);
+	check_set_against_std<robin_hood_set, int>([](sizet i) { return static_cast<int>(i); }, 0, 19);
+	check_set_against_std<sstd::unordered_set<std::string>, std::string>([](sizet i) { return "key " + std::to_string(i); }, 0, 20);
+	print("sstd::unordered_set against std::unordered_set: ok\n");
+}
+// Group by key with a sum and a count, the same answer as one std::unordered_map whatever the thread count
+void test_parallel_aggregate() {
+	struct row {
+		int key;
+		int value;
+	};
+	struct sum_count {
+		long long sum = 0;
+		int count = 0;
+	};
+	std::vector<row> rows;
+	test_random next{ 21 };
+	for (int i = 0; i < 200000; ++i) {
+		rows.push_back({ static_cast<int>(next(5000)), static_cast<int>(next(1000)) });
+	}
+	std::unordered_map<int, sum_count> expected;
+	for (const row& r : rows) {
+		expected[r.key].sum += r.value;
+		++expected[r.key].count;
+	}
+
+	const auto key_fn = [](const row& r) { return r.key; };
+	const auto combine_fn = [](sum_count& agg, const row& r) { agg.sum += r.value; ++agg.count; };
+	const auto merge_fn = [](sum_count& agg, const sum_count& other) { agg.sum += other.sum; agg.count += other.count; };
+	// 1000 threads gets capped, 0 means 1, and a handful of rows never starts a thread
+	for (sizet threads : { sizet(0), sizet(1), sizet(4), sizet(1000) }) {
+		const auto res = sstd::parallel_aggregate<sum_count>(rows.begin(), rows.end(), key_fn, combine_fn, merge_fn, threads);
+		SSTD_ASSERT(res.size() == expected.size());
+		sizet seen = 0;
+		res.for_each([&](const int& key, const sum_count& agg) {
+			const sum_count& ref = expected.at(key);
+			SSTD_ASSERT(agg.sum == ref.sum && agg.count == ref.count && res.partition_of(key) < res.partition_count());
+			++seen;
+		});
+		SSTD_ASSERT(seen == expected.size());
+		sum_count found;
+		SSTD_ASSERT(res.find(42, found) && found.count == expected[42].count && !res.contains(-1) && !res.find(-1, found));
+
+		sstd::unordered_map<int, sum_count> collected;
+		res.collect(collected);
+		SSTD_ASSERT(collected.size() == expected.size() && collected[7].sum == expected[7].sum);
+	}
+	const auto few = sstd::parallel_aggregate<sum_count>(rows.begin(), rows.begin() + 10, key_fn, combine_fn, merge_fn, 8);
+	SSTD_ASSERT(few.partition_count() == 1 && few.size() <= 10);
+	const auto none = sstd::parallel_aggregate<sum_count>(rows.begin(), rows.begin(), key_fn, combine_fn, merge_fn, 8);
+	SSTD_ASSERT(none.empty() && !none.contains(0));
+	print("sstd::parallel_aggregate against std::unordered_map: ok\n");
+}
+// Iterators hand out references into the table, and skip whole groups of empty slots
+void test_unordered_map_iterators() {
+	sstd::unordered_map<std::string, int> map;
+	for (int i = 0; i < 20000; ++i) {
+		map.insert("key " + std::to_string(i), i);
+	}
+	// Almost empty, the few keys left are spread over a big table
+	for (int i = 0; i < 20000; ++i) {
+		if (i % 97) {
+			map.erase("key " + std::to_string(i));
+		}
+	}
+	sizet seen = 0;
+	for (auto itr = map.begin(); itr != map.end(); ++itr) {
+		SSTD_ASSERT(itr->first == "key " + std::to_string(itr->second) && itr->second % 97 == 0);
+		// Writes go straight into the table
+		itr->second += 1;
+		(*itr).second *= 2;
+		++seen;
+	}
+	SSTD_ASSERT(seen == map.size() && seen == (20000 + 96) / 97);
+	const sstd::unordered_map<std::string, int>& const_map = map;
+	const std::string* first_key = &const_map.begin()->first;
+	SSTD_ASSERT(first_key == &map.begin()->first);
+	for (auto itr = const_map.cbegin(); itr != const_map.cend(); itr++) {
+		SSTD_ASSERT(itr->second == (std::stoi(itr->first.substr(4)) + 1) * 2);
+	}
+
+	sstd::unordered_map<int, int> empty;
+	SSTD_ASSERT(empty.begin() == empty.end());
+	empty[1] = 1;
+	empty.erase(1);
+	SSTD_ASSERT(empty.begin() == empty.end());
+	print("sstd::unordered_map iterators: ok\n");
+}
+// Every key hashes the same, only ever 2 buckets and the stash for all of them
+struct same_hash {
+	sizet operator()(const int&) const noexcept {
+		return 42;
+	}
+};
+void test_cuckoo_map() {
+	sstd::cuckoo_map<int, int> map;
+	check_map_against_std<int, int>(map, [](sizet i) { return static_cast<int>(i); }, [](int i) { return i; }, 5000, 100000, 22);
+	SSTD_ASSERT(map.load_factor() <= 1);
+
+	// Moving takes the buckets, the moved-from map still works
+	const sizet size = map.size();
+	sstd::cuckoo_map<int, int> moved = std::move(map);
+	SSTD_ASSERT(moved.size() == size && map.empty() && map.begin() == map.end() && !map.contains(1));
+	map[1] = 2;
+	SSTD_ASSERT(map.size() == 1 && map.find(1)->second == 2);
+	map = std::move(moved);
+	SSTD_ASSERT(map.size() == size);
+	check_map_against_std<int, int>(moved, [](sizet i) { return static_cast<int>(i); }, [](int i) { return i; }, 100, 1000, 23);
+
+	sstd::cuckoo_map<int, int, same_hash> flood;
+	bool threw = false;
+	try {
+		for (int i = 0; i < 100; ++i) {
+			flood[i] = i;
+		}
+	}
+	catch (const std::overflow_error&) {
+		threw = true;
+	}
+	SSTD_ASSERT(threw && flood.size() == 16 && flood.stash_size() == 8);
+	for (int i = 0; i < 16; ++i) {
+		SSTD_ASSERT(flood.find(i)->second == i);
+	}
+	print("sstd::cuckoo_map against std::unordered_map: ok\n");
+}
+// Built by the compiler, every key is found with one probe and nothing else is
+constexpr auto test_opcodes = sstd::make_frozen_map<std::string_view, int>({
+	{ "add", 1 }, { "sub", 2 }, { "mul", 3 }, { "div", 4 }, { "mod", 5 }, { "and", 6 }, { "or", 7 }, { "xor", 8 },
+	{ "shl", 9 }, { "shr", 10 }, { "load", 11 }, { "store", 12 }, { "jump", 13 }, { "call", 14 }, { "ret", 15 }
+});
+static_assert(test_opcodes.at("sub") == 2 && test_opcodes.size() == 15 && !test_opcodes.contains("nop"), "frozen_map isn't constexpr");
+constexpr auto test_squares = [] {
+	std::pair<int, int> items[500] = {};
+	for (int i = 0; i < 500; ++i) {
+		items[i].first = i * 7919;
+		items[i].second = i * i;
+	}
+	return sstd::frozen_map<int, int, 500>(items);
+}();
+void test_frozen_map() {
+	for (auto itr = test_opcodes.begin(); itr != test_opcodes.end(); ++itr) {
+		SSTD_ASSERT(test_opcodes.find(itr->key) == &itr->elt);
+	}
+	SSTD_ASSERT(test_opcodes.find("") == nullptr && test_opcodes.find("adds") == nullptr && test_opcodes.find("ad") == nullptr);
+	bool threw = false;
+	try {
+		test_opcodes.at("nop");
+	}
+	catch (const std::out_of_range&) {
+		threw = true;
+	}
+	SSTD_ASSERT(threw);
+
+	for (int i = 0; i < 500 * 7919; ++i) {
+		const int* elt = test_squares.find(i);
+		SSTD_ASSERT(i % 7919 == 0 ? elt != nullptr && *elt == (i / 7919) * (i / 7919) : elt == nullptr);
+	}
+	print("sstd::frozen_map: ok\n");
+}
+// lru_cache against a list + map model, in recency order, and clock_cache against its capacity and a second chance
+void test_caches() {
+	const sizet capacity = 64;
+	sstd::lru_cache<int, int> lru(capacity);
+	std::list<std::pair<int, int> > order;
+	std::unordered_map<int, std::list<std::pair<int, int> >::iterator> where;
+	sstd::cache_stats expected_stats;
+	test_random next{ 24 };
+	for (int step = 0; step < 50000; ++step) {
+		const int key = static_cast<int>(next(200));
+		const auto found = where.find(key);
+		switch (next(4)) {
+		case 0:
+			SSTD_ASSERT(lru.erase(key) == (found != where.end()));
+			if (found != where.end()) {
+				order.erase(found->second);
+				where.erase(found);
+			}
+			break;
+		case 1: {
+			int* elt = lru.get(key);
+			SSTD_ASSERT((elt != nullptr) == (found != where.end()));
+			if (found != where.end()) {
+				SSTD_ASSERT(*elt == found->second->second);
+				order.splice(order.begin(), order, found->second);
+				++expected_stats.hits;
+			}
+			else {
+				++expected_stats.misses;
+			}
+			break;
+		}
+		default:
+			lru.put(key, step);
+			if (found != where.end()) {
+				found->second->second = step;
+				order.splice(order.begin(), order, found->second);
+				break;
+			}
+			if (order.size() == capacity) {
+				where.erase(order.back().first);
+				order.pop_back();
+				++expected_stats.evictions;
+			}
+			order.emplace_front(key, step);
+			where[key] = order.begin();
+			break;
+		}
+		SSTD_ASSERT(lru.size() == order.size() && lru.contains(key) == (where.count(key) == 1));
+	}
+	auto itr = order.begin();
+	lru.for_each([&](const int& key, const int& elt) {
+		SSTD_ASSERT(itr != order.end() && itr->first == key && itr->second == elt);
+		++itr;
+	});
+	SSTD_ASSERT(itr == order.end());
+	SSTD_ASSERT(lru.stats().hits == expected_stats.hits && lru.stats().misses == expected_stats.misses && lru.stats().evictions == expected_stats.evictions);
+	lru.clear();
+	SSTD_ASSERT(lru.empty() && lru.get(1) == nullptr);
+
+	// 1, 2 and 3 get read after going in, so the hand passes them and takes 4
+	sstd::clock_cache<int, int> small(4);
+	for (int i = 1; i <= 4; ++i) {
+		small.put(i, i * 10);
+	}
+	SSTD_ASSERT(*small.get(1) == 10 && *small.get(2) == 20 && *small.get(3) == 30);
+	small.put(5, 50);
+	SSTD_ASSERT(small.size() == 4 && !small.contains(4) && *small.peek(5) == 50 && small.stats().evictions == 1);
+
+	sstd::clock_cache<int, int> clock(capacity);
+	std::unordered_map<int, int> last_put;
+	for (int step = 0; step < 50000; ++step) {
+		const int key = static_cast<int>(next(200));
+		if (next(2)) {
+			clock.put(key, step);
+			last_put[key] = step;
+		}
+		else if (const int* elt = clock.get(key)) {
+			// Whatever is still cached is what was put last
+			SSTD_ASSERT(*elt == last_put[key]);
+		}
+		SSTD_ASSERT(clock.size() <= capacity && clock.contains(key) == (clock.peek(key) != nullptr));
+	}
+	SSTD_ASSERT(clock.size() == capacity && clock.stats().evictions > 0);
+	print("sstd::lru_cache and sstd::clock_cache: ok\n");
+}
+// Every key in expected and nothing else
+template<typename _Map>
+void check_persistent_equals(const _Map& map, const std::map<int, int>& expected) {
+	SSTD_ASSERT(map.size() == expected.size());
+	sizet seen = 0;
+	for (auto itr = map.begin(); itr != map.end(); ++itr) {
+		const auto ref = expected.find(itr->first);
+		SSTD_ASSERT(ref != expected.end() && ref->second == itr->second);
+		++seen;
+	}
+	SSTD_ASSERT(seen == expected.size());
+	for (const auto& pair : expected) {
+		SSTD_ASSERT(map.find(pair.first) && *map.find(pair.first) == pair.second);
+	}
+}
+// Only 4 different hashes, so almost everything ends up in collision nodes
+struct tiny_hash {
+	sizet operator()(const int& key) const noexcept {
+		return static_cast<sizet>(key & 3);
+	}
+};
+// Every old version stays exactly as it was, whatever came after it
+template<typename _Map>
+void check_persistent_versions(const unsigned seed) {
+	std::vector<_Map> versions;
+	std::vector<std::map<int, int> > snapshots;
+	_Map map;
+	std::map<int, int> expected;
+	test_random next{ seed };
+	for (int step = 0; step < 20000; ++step) {
+		const int key = static_cast<int>(next(2000));
+		if (next(3)) {
+			map = map.insert(key, step);
+			expected[key] = step;
+		}
+		else {
+			map = map.erase(key);
+			expected.erase(key);
+		}
+		if (step % 500 == 0) {
+			// A batch through a transient, the version it came from doesn't see any of it
+			versions.push_back(map);
+			snapshots.push_back(expected);
+			typename _Map::transient_type batch = map.transient();
+			for (int i = 0; i < 300; ++i) {
+				const int batch_key = static_cast<int>(next(2000));
+				if (i % 4) {
+					batch.insert(batch_key, -i);
+					expected[batch_key] = -i;
+				}
+				else {
+					batch.erase(batch_key);
+					expected.erase(batch_key);
+				}
+			}
+			map = batch.persistent();
+			// Nor does the version it handed out
+			batch.insert(-1, -1);
+			SSTD_ASSERT(!map.contains(-1) && batch.contains(-1) && batch.size() == map.size() + 1);
+		}
+		if (step % 50 == 0) {
+			versions.push_back(map);
+			snapshots.push_back(expected);
+		}
+	}
+	for (sizet i = 0; i < versions.size(); ++i) {
+		check_persistent_equals(versions[i], snapshots[i]);
+	}
+}
+void test_persistent_map() {
+	check_persistent_versions<sstd::persistent_map<int, int> >(25);
+	check_persistent_versions<sstd::persistent_map<int, int, tiny_hash> >(26);
+
+	const sstd::persistent_map<int, int> empty;
+	const sstd::persistent_map<int, int> one = empty.insert(1, 1);
+	SSTD_ASSERT(empty.empty() && empty.begin() == empty.end() && one.size() == 1 && one.erase(1).empty() && one.erase(2).size() == 1);
+	print("sstd::persistent_map against std::map snapshots: ok\n");
+}
+// Both maps hold exactly the same keys and elements
+template<typename _Map>
+bool maps_equal(const _Map& a, const _Map& b) {
+	if (a.size() != b.size()) {
+		return false;
+	}
+	for (auto itr = a.begin(); itr != a.end(); ++itr) {
+		const auto other = b.find(itr->first);
+		if (other == b.end() || other->second != itr->second) {
+			return false;
+		}
+	}
+	return true;
+}
+template<typename T, typename _MakeT>
+void check_vector_copies(_MakeT make) {
+	sstd::vector<T> vec;
+	for (int i = 0; i < 1000; ++i) {
+		vec.push_back(make(i));
+	}
+	sstd::vector<T> copy = vec;
+	copy[0] = make(-1);
+	SSTD_ASSERT(copy.size() == vec.size() && vec[0] == make(0) && copy[999] == make(999));
+	// Into a smaller buffer, then into one that's big enough already
+	sstd::vector<T> small;
+	small.push_back(make(5));
+	small = vec;
+	SSTD_ASSERT(small.size() == 1000 && small[500] == make(500));
+	small = sstd::vector<T>();
+	small = copy;
+	SSTD_ASSERT(small.size() == 1000 && small[0] == make(-1));
+	const sstd::vector<T>& self = small;
+	small = self;
+	SSTD_ASSERT(small.size() == 1000 && small[1] == make(1));
+
+	sstd::vector<T> moved = std::move(copy);
+	SSTD_ASSERT(moved.size() == 1000 && copy.size() == 0);
+	copy.push_back(make(7));
+	moved = std::move(copy);
+	SSTD_ASSERT(moved.size() == 1 && moved[0] == make(7) && copy.size() == 0);
+	const sstd::vector<T> empty_copy = sstd::vector<T>(copy);
+	SSTD_ASSERT(empty_copy.size() == 0);
+}
+sstd::unordered_map<std::string, int> make_string_map(const int count) {
+	sstd::unordered_map<std::string, int> res;
+	for (int i = 0; i < count; ++i) {
+		res.insert("key " + std::to_string(i), i);
+	}
+	return res;
+}
+// Copies are deep and moved-from containers are empty and still usable
+void test_container_copies() {
+	check_vector_copies<int>([](int i) { return i; });
+	check_vector_copies<std::string>([](int i) { return "a string too long for the small string buffer " + std::to_string(i); });
+
+	// Copied in the middle of a rehash, both tables come along
+	sstd::unordered_map<int, int> map;
+	map.set_rehash_step(1);
+	for (int i = 0; !map.rehashing() || i < 1000; ++i) {
+		map[i] = i;
+	}
+	sstd::unordered_map<int, int> copy = map;
+	SSTD_ASSERT(copy.rehashing() && maps_equal(map, copy));
+	for (int i = 0; i < 5000; ++i) {
+		map[i] = -i;
+		copy[i] = -i;
+	}
+	copy[-1] = 1;
+	SSTD_ASSERT(!map.contains(-1) && copy.size() == map.size() + 1);
+	copy.erase(-1);
+	SSTD_ASSERT(maps_equal(map, copy));
+
+	sstd::unordered_map<std::string, int> strs = make_string_map(3000);
+	sstd::unordered_map<std::string, int> str_copy = strs;
+	str_copy = str_copy;
+	SSTD_ASSERT(str_copy.size() == 3000 && maps_equal(strs, str_copy));
+	sstd::unordered_map<std::string, int> moved = std::move(str_copy);
+	SSTD_ASSERT(maps_equal(strs, moved) && str_copy.empty() && str_copy.begin() == str_copy.end() && !str_copy.contains("key 1"));
+	str_copy["key 1"] = 1;
+	SSTD_ASSERT(str_copy.size() == 1 && str_copy.find("key 1")->second == 1);
+	moved = std::move(str_copy);
+	SSTD_ASSERT(moved.size() == 1 && str_copy.empty());
+	str_copy = strs;
+	SSTD_ASSERT(maps_equal(strs, str_copy));
+	print("sstd::vector and sstd::unordered_map copies and moves: ok\n");
+}
 void test_unordered_map() {
 	initTimeFunc();
 	int abs = 0;
@@ -173,10 +1254,181 @@ void test_unordered_map() {
 		print("		std::unordered_map		clear:			", std_clear, " ms\n");
 	}
 }
-#include <algorithm>
+
+// Run 'threads' readers and one writer for a while, returns how many reads and writes got done per millisecond
+// The writer gets called with 0, 1, 2, ... and readers look up keys in [0, key_range)
+// ( Writes count too, a lock that lets readers starve the writer looks great on reads alone )
+template<typename _Read, typename _Write>
+std::pair<Decimal, Decimal> ops_per_milli(unsigned threads, const int key_range, _Read read, _Write write) {
+	const auto duration = milliseconds(200);
+	std::atomic<bool> stop(false);
+	std::atomic<sizet> total(0);
+	int writes = 0;
+
+	std::thread writer([&]() {
+		for (; !stop.load(std::memory_order_relaxed); ++writes) {
+			write(writes);
+		}
+	});
+	std::vector<std::thread> readers;
+	for (unsigned t = 0; t < threads; ++t) {
+		readers.emplace_back([&, t]() {
+			sizet reads = 0;
+			unsigned key = t * 7919;
+			while (!stop.load(std::memory_order_relaxed)) {
+				for (int j = 0; j < 256; ++j) {
+					key = key * 1103515245 + 12345;
+					read(static_cast<int>(key % key_range));
+				}
+				reads += 256;
+			}
+			total += reads;
+		});
+	}
+	std::this_thread::sleep_for(duration);
+	stop = true;
+	writer.join();
+	for (std::thread& reader : readers) {
+		reader.join();
+	}
+	return { static_cast<Decimal>(total) / duration.count(), static_cast<Decimal>(writes) / duration.count() };
+}
+
+void test_read_mostly_unordered_map() {
+	const int _Size = 1000000;
+	const unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+	for (unsigned threads = 1; threads <= max_threads; ++threads) {
+		// Fresh maps every round, so the writer grows them again
+		sstd::read_mostly_unordered_map<int, int> sstd_map;
+		std::unordered_map<int, int> std_map;
+		std::shared_mutex std_lock;
+		for (int i = 0; i < _Size / 2; ++i) {
+			sstd_map.insert(i, i);
+			std_map[i] = i;
+		}
+		// The writer updates a key, inserts a new one and erases an old one,
+		// so the tables keep growing, getting rebuilt over their Deleted slots and retired
+		print(threads, " readers while one writer updates, inserts and erases: ");
+		const std::pair<Decimal, Decimal> sstd_ops = ops_per_milli(threads, _Size,
+			[&](int key) {
+				int val;
+				return sstd_map.find(key, val);
+			},
+			[&](int i) {
+				sstd_map.insert(i % (_Size / 2), i);
+				sstd_map.insert(_Size / 2 + i, i);
+				sstd_map.erase(_Size / 2 + i - _Size / 4);
+			});
+		const std::pair<Decimal, Decimal> std_ops = ops_per_milli(threads, _Size,
+			[&](int key) {
+				std::shared_lock<std::shared_mutex> guard(std_lock);
+				return std_map.find(key) != std_map.end();
+			},
+			[&](int i) {
+				std::unique_lock<std::shared_mutex> guard(std_lock);
+				std_map[i % (_Size / 2)] = i;
+				std_map[_Size / 2 + i] = i;
+				std_map.erase(_Size / 2 + i - _Size / 4);
+			});
+
+		print("		custom sstd::read_mostly_unordered_map	find:		", sstd_ops.first, " reads / ms	", sstd_ops.second, " writes / ms");
+		print("		std::unordered_map + std::shared_mutex	find:		", std_ops.first, " reads / ms	", std_ops.second, " writes / ms\n");
+	}
+}
+// Run 'threads' threads that all call op(key) on random keys in [0, key_range) for a while,
+// returns how many calls got done per millisecond
+template<typename _Op>
+Decimal mixed_ops_per_milli(unsigned threads, const int key_range, _Op op) {
+	const auto duration = milliseconds(200);
+	std::atomic<bool> stop(false);
+	std::atomic<sizet> total(0);
+
+	std::vector<std::thread> workers;
+	for (unsigned t = 0; t < threads; ++t) {
+		workers.emplace_back([&, t]() {
+			sizet ops = 0;
+			unsigned key = t * 7919 + 1;
+			while (!stop.load(std::memory_order_relaxed)) {
+				for (int j = 0; j < 256; ++j) {
+					key = key * 1103515245 + 12345;
+					op(static_cast<int>((key >> 4) % key_range), key & 3);
+				}
+				ops += 256;
+			}
+			total += ops;
+		});
+	}
+	std::this_thread::sleep_for(duration);
+	stop = true;
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	return static_cast<Decimal>(total) / duration.count();
+}
+
+void test_concurrent_unordered_map() {
+	const int _Size = 1000000;
+	const unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+	Decimal sstd_single = 0, std_single = 0;
+	for (unsigned threads = 1; threads <= max_threads; ++threads) {
+		// Fresh maps every round, a quarter of the calls insert and the rest look up
+		sstd::concurrent_unordered_map<int, int> sstd_map;
+		std::unordered_map<int, int> std_map;
+		std::mutex std_lock;
+		print(threads, " threads inserting and looking up: ");
+		const Decimal sstd_ops = mixed_ops_per_milli(threads, _Size, [&](int key, unsigned kind) {
+			if (kind == 0) {
+				sstd_map.insert(key, key);
+				return true;
+			}
+			return sstd_map.contains(key);
+		});
+		const Decimal std_ops = mixed_ops_per_milli(threads, _Size, [&](int key, unsigned kind) {
+			std::lock_guard<std::mutex> guard(std_lock);
+			if (kind == 0) {
+				std_map[key] = key;
+				return true;
+			}
+			return std_map.find(key) != std_map.end();
+		});
+		if (threads == 1) {
+			sstd_single = sstd_ops;
+			std_single = std_ops;
+		}
+
+		print("		custom sstd::concurrent_unordered_map	insert + find:	", sstd_ops, " ops / ms	", sstd_ops / sstd_single, "x one thread");
+		print("		std::unordered_map + std::mutex		insert + find:	", std_ops, " ops / ms	", std_ops / std_single, "x one thread\n");
+	}
+}
 #include <string>
 #include <set>
 int main() {
+	test_vector_empty_ranges();
+	test_small_vector();
+	test_unordered_map_against_std();
+	test_robin_hood_map();
+	test_incremental_rehash();
+	test_cached_hash();
+	test_split_storage();
+	test_transparent_lookup();
+	test_concurrent_unordered_map_against_std();
+	test_batch_operations();
+	test_hash_functions();
+	test_fastrange_reduce();
+	test_emplace_operations();
+	test_small_unordered_map();
+	test_mapped_unordered_map();
+	test_map_stats();
+	test_unordered_set();
+	test_parallel_aggregate();
+	test_unordered_map_iterators();
+	test_cuckoo_map();
+	test_frozen_map();
+	test_caches();
+	test_persistent_map();
+	test_container_copies();
 	test_vector();
+	test_read_mostly_unordered_map();
+	test_concurrent_unordered_map();
 	return 0;
 }
\ No newline at end of file
@@ -2,11 +2,32 @@
 #define SSTD_UNORDERED_MAP_INCLUDED
 
 #include "core.hpp"
+#include "hash.hpp"
+#include "Iterator.hpp"
 
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <initializer_list>
+#include <tuple>
 #include <utility>
 #include <ratio>
+#include <string>
+#include <type_traits>
+#include <stdexcept>
+
+#if defined(SSTD_MAP_STATS)
+#include <chrono>
+#include <ostream>
+#endif
+
+#if defined(__AVX2__)
+#define SSTD_GROUP_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SSTD_GROUP_SSE2
+#include <emmintrin.h>
+#endif
 
 SSTD_BEGIN
 
@@ -16,12 +37,24 @@ SSTD_BEGIN
 //
 // -----------------------------------------
 
+// The hashers themselves live in hash.hpp
+
+// Is hashing a key expensive enough that every slot should keep its full hash
+// With a cached hash, a probe rejects most keys by comparing hashes instead of running operator==,
+// and growing the table never calls the hash function again
+// It costs one sizet per slot, so only keys that aren't a number / pointer / enum opt in by default
+// Specialize this to change it for your own key type
 template<typename T>
-struct _Deault_Hash{
-	SSTD_INLINE SSTD_CONSTEXPR sizet operator()(const T& key) const {
-		return std::hash<T>::_Do_hash(key);
-	}
-};
+struct is_hash_expensive : std::integral_constant<bool,
+	!std::is_arithmetic<T>::value && !std::is_pointer<T>::value && !std::is_enum<T>::value
+> {};
+
+// Should the keys and the elements live in two separate arrays
+// Probing only ever reads keys, so with big elements a key only array packs a lot more keys into a cache line,
+// and the element is only touched once the key is found
+// On by default for elements of a cache line or more, specialize this to change it
+template<typename _KeyT, typename _EltT>
+struct is_split_storage : std::integral_constant<bool, (sizeof(_EltT) >= 64)> {};
 
 // -----------------------------------------
 //
@@ -29,36 +62,270 @@ struct _Deault_Hash{
 //
 // -----------------------------------------
 
-template<typename T, typename _Hash>
+// Every probe has to turn a 64 bit value into an index below m,
+// the reduction policy of the probing functor decides how, without ever dividing
+//
+//   reduce(x, m)          : x into [0, m)
+//   wrap(pos, offset, m)  : ( pos + offset ) mod m, for a pos that is already below m
+//   capacity(n)           : the capacity a table asked for n slots gets
+//   id                    : tells the policies apart in a saved table ( see unordered_map::save )
+
+// m is a power of 2, just keep the low bits
+struct _Mask_Reduce {
+	static SSTD_CONSTEXPR uint32 id = 1;
+
+	static SSTD_INLINE SSTD_CONSTEXPR sizet capacity(const sizet& n) noexcept {
+		return _Bit_Ceil(n);
+	}
+
+	static SSTD_INLINE SSTD_CONSTEXPR sizet reduce(const sizet& x, const sizet& m) noexcept {
+		return x & (m - 1);
+	}
+	static SSTD_INLINE SSTD_CONSTEXPR sizet wrap(const sizet& pos, const sizet& offset, const sizet& m) noexcept {
+		return (pos + offset) & (m - 1);
+	}
+};
+
+// Lemire's fastrange, any m works, ( x * m ) >> 64 maps x into [0, m) with one multiply
+// It reads the high bits of x, so the top 7 bits are shifted out first, those already are the control byte ( see _Ctrl )
+// wrap() only divides when the offset itself reaches m ( say quadratic probing after sqrt(m) probes )
+struct _Fastrange_Reduce {
+	static SSTD_CONSTEXPR uint32 id = 2;
+
+	static SSTD_INLINE SSTD_CONSTEXPR sizet capacity(const sizet& n) noexcept {
+		return n ? n : 1;
+	}
+
+	static SSTD_INLINE sizet reduce(const sizet& x, const sizet& m) noexcept {
+		uint64 low = static_cast<uint64>(x) << 7, high = m;
+		_Mum(low, high);
+		return static_cast<sizet>(high);
+	}
+	static SSTD_INLINE SSTD_CONSTEXPR sizet wrap(const sizet& pos, sizet offset, const sizet& m) noexcept {
+		if (offset >= m) {
+			offset %= m;
+		}
+		return pos >= m - offset ? pos - (m - offset) : pos + offset;
+	}
+};
+
+// Every probing functor gets the hash of the key ( computed once per operation ),
+// the probe count i and the amount of groups / slots m
+// The last template argument is the reduction policy, _Mask_Reduce unless you want a capacity that isn't a power of 2
+// id is only there to check that a saved table gets probed the same way it was built ( see _Probe_Id )
+
+template<typename T, typename _Hash, typename _Reduce = _Mask_Reduce>
 struct _Linear_Prob {
-	SSTD_INLINE sizet operator()(const T& key, const sizet& i, const sizet& m, const _Hash hasher) const {
-		return (hasher(key) + i) % m;
+	using reduce_type = _Reduce;
+	static SSTD_CONSTEXPR uint32 id = 1;
+	SSTD_INLINE sizet operator()(const sizet& hash, const sizet& i, const sizet& m) const {
+		return _Reduce::wrap(_Reduce::reduce(hash, m), i, m);
 	}
 };
-template<typename T, int32 c1, int32 c2, typename _Hash>
+template<typename T, int32 c1, int32 c2, typename _Hash, typename _Reduce = _Mask_Reduce>
 struct _Quadratic_Prob1 {
-	SSTD_INLINE sizet operator()(const T& key, const sizet& i, const sizet& m, const _Hash hasher) const {
-		return (hasher(key) + c1 * i + c2 * i * i) % m;
+	using reduce_type = _Reduce;
+	static SSTD_CONSTEXPR uint32 id = 2 | uint32(c1 & 0xff) << 16 | uint32(c2 & 0xff) << 24;
+	SSTD_INLINE sizet operator()(const sizet& hash, const sizet& i, const sizet& m) const {
+		return _Reduce::wrap(_Reduce::reduce(hash, m), c1 * i + c2 * i * i, m);
 	}
 };
-template<typename T, int32 c1, int32 c2, typename _Hash>
+template<typename T, int32 c1, int32 c2, typename _Hash, typename _Reduce = _Mask_Reduce>
 struct _Quadratic_Prob2 {
-	SSTD_INLINE sizet operator()(const T& key, const sizet& i, const sizet& m, const _Hash hasher) const {
-		return (hasher(key) - pow(-1, i) * (i / 2) * (i / 2)) % m;
+	using reduce_type = _Reduce;
+	static SSTD_CONSTEXPR uint32 id = 3 | uint32(c1 & 0xff) << 16 | uint32(c2 & 0xff) << 24;
+	SSTD_INLINE sizet operator()(const sizet& hash, const sizet& i, const sizet& m) const {
+		// hash - (-1)^i * (i / 2)^2, subtracting is adding m - ( (i / 2)^2 mod m )
+		const sizet home = _Reduce::reduce(hash, m);
+		const sizet square = (i / 2) * (i / 2);
+		return i & 1 ? _Reduce::wrap(home, square, m) : _Reduce::wrap(home, m - _Reduce::wrap(0, square, m), m);
 	}
 };
-template<typename T, typename _Hash>
+template<typename T, typename _Hash, typename _Reduce = _Mask_Reduce>
 struct _Double_Hash_Prob {
-	SSTD_INLINE sizet operator()(const T& key, const sizet& i, const sizet& m, const _Hash hasher) const {
-		const sizet _Hash_Res = hasher(key);					  
-		return (_Hash_Res + // First hash
-			i * ( _Hash_Res & 0xffffffffffffffff // i * second hash
+	using reduce_type = _Reduce;
+	static SSTD_CONSTEXPR uint32 id = 4;
+	SSTD_INLINE sizet operator()(const sizet& hash, const sizet& i, const sizet& m) const {
+		// The whole sequence stays in 64 bits and gets reduced at the end,
+		// i * second hash changes the high bits too, so fastrange still spreads it
+		return _Reduce::reduce(hash + // First hash
+			i * (hash // i * second hash
 				| 0x0000000000000001 // Add this to make the second hash result an odd number
-			) 
-		) % m;
+			),
+			m
+		);
+	}
+};
+
+// Robin Hood hashing
+// Probes slot by slot ( not group by group ) and keeps every run of slots sorted by home position,
+// so an element that is far away from home can take the slot of an element that is closer to home
+// Erasing shifts the rest of the run back by one, so there are never any Deleted slots
+//
+// max_probe is the longest probe sequence an insert accepts before the table grows
+template<typename T, typename _Hash, typename _Reduce = _Mask_Reduce>
+struct _Robin_Hood_Prob {
+	using reduce_type = _Reduce;
+	static SSTD_CONSTEXPR uint32 id = 5;
+	static SSTD_CONSTEXPR bool robin_hood = true;
+	static SSTD_CONSTEXPR uint32 max_probe = 32;
+
+	SSTD_INLINE sizet operator()(const sizet& hash, const sizet& i, const sizet& m) const {
+		return _Reduce::wrap(_Reduce::reduce(hash, m), i, m);
+	}
+};
+
+// A hash functor with a member type is_transparent can hash other types than the key type directly
+// ( Say std::string_view or const char* for a std::string key ),
+// and find / contains / erase will take those types without ever constructing a key
+// Those types need to be comparable with the key using operator==, and hash to the same value as the equal key
+template<typename _Hash, typename = void>
+struct _Is_Transparent : std::false_type {};
+template<typename _Hash>
+struct _Is_Transparent<_Hash, std::void_t<typename _Hash::is_transparent> > : std::true_type {};
+
+// Reduction policy of a probing functor, functors without a reduce_type take a power of 2 capacity
+template<typename _ProbT, typename = void>
+struct _Probe_Reduce {
+	using type = _Mask_Reduce;
+};
+template<typename _ProbT>
+struct _Probe_Reduce<_ProbT, std::void_t<typename _ProbT::reduce_type> > {
+	using type = typename _ProbT::reduce_type;
+};
+
+// Probing functor id and reduction policy id in one number, 0 for a functor without an id
+template<typename _ProbT, typename = void>
+struct _Probe_Id : std::integral_constant<uint32, 0> {};
+template<typename _ProbT>
+struct _Probe_Id<_ProbT, std::void_t<decltype(_ProbT::id)> > : std::integral_constant<uint32,
+	_ProbT::id | _Probe_Reduce<_ProbT>::type::id << 8
+> {};
+
+template<typename _ProbT, typename = void>
+struct _Is_Robin_Hood : std::false_type {};
+template<typename _ProbT>
+struct _Is_Robin_Hood<_ProbT, std::void_t<decltype(_ProbT::robin_hood)> > : std::integral_constant<bool, _ProbT::robin_hood> {};
+
+
+// -----------------------------------------
+//
+//   Control bytes
+//
+// -----------------------------------------
+
+// Every slot owns one byte in a separate control array,
+// so probing can test a whole group of slots at once without touching any key
+//
+//   Empty    : 1000 0000
+//   Deleted  : 1111 1110
+//   Sentinel : 1111 1111  ( padding behind the last slot, never matches anything )
+//   Full     : 0xxx xxxx  ( the top 7 bits of the hash )
+struct _Ctrl {
+	static SSTD_CONSTEXPR int8 Empty = -128;
+	static SSTD_CONSTEXPR int8 Deleted = -2;
+	static SSTD_CONSTEXPR int8 Sentinel = -1;
+
+	static SSTD_INLINE SSTD_CONSTEXPR bool is_full(int8 ctrl) noexcept {
+		return ctrl >= 0;
+	}
+	// The 7 bit hash fragment stored in a full control byte
+	static SSTD_INLINE SSTD_CONSTEXPR int8 h2(sizet hash) noexcept {
+		return static_cast<int8>(hash >> (sizeof(sizet) * 8 - 7));
+	}
+};
+
+// A group is the amount of control bytes tested by one compare
+// Each match function returns a bitmask with one bit per matching slot,
+// slot index of a bit is ( bit position >> shift )
+#if defined(SSTD_GROUP_AVX2)
+
+struct _Group {
+	static SSTD_CONSTEXPR sizet width = 32;
+	static SSTD_CONSTEXPR uint32 shift = 0;
+
+	SSTD_EXPLICIT _Group(const int8* pos) noexcept :
+		m_ctrl(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos))) {
+
+	}
+
+	SSTD_INLINE uint64 match(int8 h2) const noexcept {
+		return static_cast<uint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_set1_epi8(h2), m_ctrl)));
+	}
+	SSTD_INLINE uint64 match_empty() const noexcept {
+		return match(_Ctrl::Empty);
+	}
+	// Every byte smaller than Sentinel is either Empty or Deleted
+	SSTD_INLINE uint64 match_empty_or_deleted() const noexcept {
+		return static_cast<uint32>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(_mm256_set1_epi8(_Ctrl::Sentinel), m_ctrl)));
+	}
+	SSTD_INLINE uint64 match_full() const noexcept {
+		return static_cast<uint32>(~_mm256_movemask_epi8(m_ctrl));
+	}
+private:
+	__m256i m_ctrl;
+};
+
+#elif defined(SSTD_GROUP_SSE2)
+
+struct _Group {
+	static SSTD_CONSTEXPR sizet width = 16;
+	static SSTD_CONSTEXPR uint32 shift = 0;
+
+	SSTD_EXPLICIT _Group(const int8* pos) noexcept :
+		m_ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {
+
+	}
+
+	SSTD_INLINE uint64 match(int8 h2) const noexcept {
+		return static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl)));
+	}
+	SSTD_INLINE uint64 match_empty() const noexcept {
+		return match(_Ctrl::Empty);
+	}
+	// Every byte smaller than Sentinel is either Empty or Deleted
+	SSTD_INLINE uint64 match_empty_or_deleted() const noexcept {
+		return static_cast<uint32>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(_Ctrl::Sentinel), m_ctrl)));
+	}
+	SSTD_INLINE uint64 match_full() const noexcept {
+		return static_cast<uint32>(~_mm_movemask_epi8(m_ctrl)) & 0xffff;
+	}
+private:
+	__m128i m_ctrl;
+};
+
+#else
+
+// No SIMD, so do the same thing on 8 bytes packed in a uint64
+// match() can give false positives, which are filtered out by the key compare anyway
+struct _Group {
+	static SSTD_CONSTEXPR sizet width = 8;
+	static SSTD_CONSTEXPR uint32 shift = 3;
+
+	SSTD_EXPLICIT _Group(const int8* pos) noexcept {
+		std::memcpy(&m_ctrl, pos, sizeof(m_ctrl));
+	}
+
+	SSTD_INLINE uint64 match(int8 h2) const noexcept {
+		const uint64 x = m_ctrl ^ (s_lsbs * static_cast<uint8>(h2));
+		return (x - s_lsbs) & ~x & s_msbs;
+	}
+	SSTD_INLINE uint64 match_empty() const noexcept {
+		return m_ctrl & ~(m_ctrl << 6) & s_msbs;
 	}
+	SSTD_INLINE uint64 match_empty_or_deleted() const noexcept {
+		return m_ctrl & ~(m_ctrl << 7) & s_msbs;
+	}
+	SSTD_INLINE uint64 match_full() const noexcept {
+		return ~m_ctrl & s_msbs;
+	}
+private:
+	static SSTD_CONSTEXPR uint64 s_lsbs = 0x0101010101010101ull;
+	static SSTD_CONSTEXPR uint64 s_msbs = 0x8080808080808080ull;
+	uint64 m_ctrl;
 };
 
+#endif
 
 // -----------------------------------------
 //
@@ -69,17 +336,92 @@ struct _Double_Hash_Prob {
 template<
 	typename _KeyT,
 	typename _EltT,
-	typename _Hash = _Deault_Hash<_KeyT>,
+	typename _Hash = _Default_Hash<_KeyT>,
 	typename _ProbT = _Double_Hash_Prob<_KeyT, _Hash>
 >
 class _Unordered_Map_Iterator;
 template<
 	typename _KeyT,
 	typename _EltT,
-	typename _Hash = _Deault_Hash<_KeyT>,
+	typename _Hash = _Default_Hash<_KeyT>,
 	typename _ProbT = _Double_Hash_Prob<_KeyT, _Hash>
 >
 class _Unordered_Map_Const_Iterator;
+template<
+	typename _KeyT,
+	typename _EltT,
+	typename _Hash = _Default_Hash<_KeyT>,
+	typename _ProbT = _Double_Hash_Prob<_KeyT, _Hash>
+>
+class mapped_unordered_map;
+
+// -----------------------------------------
+//
+//   Saved tables
+//
+// -----------------------------------------
+
+// What unordered_map::save writes in front of the table
+// The control bytes, slots, elements ( split storage ) and distances ( Robin Hood ) follow,
+// each one starting on a _Image_Header::align boundary, so the mapped file can be used in place
+//
+// Everything the layout or the probe sequence depends on is in here,
+// a file from a build that would probe it differently is rejected instead of giving wrong answers
+struct _Image_Header {
+	static SSTD_CONSTEXPR sizet align = 64;
+	static SSTD_CONSTEXPR uint32 version = 1;
+
+	char magic[8];
+	uint32 version_;
+	uint32 probe_id;
+	uint64 capacity;
+	uint64 size;
+	uint64 seed;
+	// The group count, and so the probe sequence, depends on the group width
+	uint32 group_width;
+	uint32 sizet_size;
+	uint32 key_size;
+	uint32 elt_size;
+	uint32 slot_size;
+	// 1 : cached hash, 2 : split storage, 4 : Robin Hood
+	uint32 flags;
+	uint64 file_size;
+
+	static SSTD_INLINE SSTD_CONSTEXPR sizet round(const sizet& n) noexcept {
+		return (n + align - 1) / align * align;
+	}
+};
+
+// -----------------------------------------
+//
+//   Stats
+//
+// -----------------------------------------
+
+// Define SSTD_MAP_STATS to make every unordered_map count what its probes and rehashes cost,
+// and get stats() / reset_stats() / debug_dump()
+// Without it none of this exists, not even the counters inside the map
+#if defined(SSTD_MAP_STATS)
+struct unordered_map_stats {
+	static SSTD_CONSTEXPR sizet buckets = 16;
+
+	// [i] : lookups that probed i groups ( i slots for Robin Hood ), the last bucket takes everything longer
+	// Every table a lookup searches counts once, so a miss during an incremental rehash counts twice
+	uint64 hit_probes[buckets] = {};
+	uint64 miss_probes[buckets] = {};
+
+	// Rehashes into a bigger table, and the ones that only cleaned out Deleted slots
+	uint64 growths = 0;
+	uint64 rebuilds = 0;
+	// Time spent moving elements into a new table
+	uint64 rehash_nanos = 0;
+
+	// Filled by stats(), from the current table
+	sizet tombstones = 0;
+	// Most groups ( slots for Robin Hood ) any element is away from its home
+	sizet max_displacement = 0;
+};
+#endif
 
 // This is a completly different implementation than the one in std
 // std::unordered_map uses close addressing / chaining
@@ -88,31 +430,80 @@ class _Unordered_Map_Const_Iterator;
 // when it comes to inserting
 // And performs 'slightly' better than std::unordered_map for other operations
 //
-// The capacity needs to be a power of 2
+// The occupancy of every slot lives in a separate control byte array ( see _Ctrl )
+// The probing function picks a group of slots instead of a single slot,
+// and the whole group is checked with one SIMD compare before any key is touched
+// ( Except for _Robin_Hood_Prob, which probes slot by slot and keeps a probe distance per slot )
+// Big elements are kept in an array of their own ( see is_split_storage )
+//
+// The capacity is a power of 2, unless the probing functor uses _Fastrange_Reduce ( see _Mask_Reduce )
 
 template<
 	typename _KeyT,	// Key type
 	typename _EltT,		// Element type
-	typename _Hash = _Deault_Hash<_KeyT>, // Hash function 
+	typename _Hash = _Default_Hash<_KeyT>, // Hash function 
 	typename _ProbT = _Double_Hash_Prob<_KeyT, _Hash> // probing function
 > 
 class unordered_map {
 public:
 	friend class _Unordered_Map_Iterator<_KeyT, _EltT, _Hash, _ProbT>;
 	friend class _Unordered_Map_Const_Iterator<_KeyT, _EltT, _Hash, _ProbT>;
+	friend class mapped_unordered_map<_KeyT, _EltT, _Hash, _ProbT>;
+	template<typename, typename, typename>
+	friend class unordered_set;
+	// Hashes every key once to pick a shard, and hands that hash down
+	template<typename, typename, typename, typename, sizet>
+	friend class concurrent_unordered_map;
 	using iterator = _Unordered_Map_Iterator<_KeyT, _EltT, _Hash, _ProbT>;
 	using const_iterator = _Unordered_Map_Const_Iterator<_KeyT, _EltT, _Hash, _ProbT>;
 private:
-	struct _Map_Element {
+	static SSTD_CONSTEXPR bool s_cache_hash = is_hash_expensive<_KeyT>::value;
+
+	// The cached hash, only there if s_cache_hash
+	template<bool _Cached, typename = void>
+	struct _Slot_Hash {
+		SSTD_INLINE void set_hash(const sizet&) noexcept {}
+	};
+	template<typename _Dummy>
+	struct _Slot_Hash<true, _Dummy> {
+		sizet hash;
+		SSTD_INLINE void set_hash(const sizet& _hash) noexcept {
+			hash = _hash;
+		}
+	};
+
+	// An empty element that doesn't do anything when constructed or destroyed isn't stored at all,
+	// every slot is just the key ( This is what unordered_set runs on )
+	static SSTD_CONSTEXPR bool s_no_elt = std::is_empty<_EltT>::value && std::is_trivial<_EltT>::value;
+	static SSTD_CONSTEXPR bool s_split = !s_no_elt && is_split_storage<_KeyT, _EltT>::value;
+
+	struct _Map_Element : _Slot_Hash<s_cache_hash> {
 		_KeyT key;
 		_EltT elt;
-		bool occupied = false;
+	};
+	// Split storage, the element lives in _Table::elts instead
+	struct _Key_Element : _Slot_Hash<s_cache_hash> {
+		_KeyT key;
+	};
+	using _Slot_T = typename std::conditional<s_split || s_no_elt, _Key_Element, _Map_Element>::type;
+
+	// The slots and their control bytes
+	struct _Table {
+		int8* ctrl = nullptr;
+		_Slot_T* slots = nullptr;
+		// Split storage only, the element of every slot
+		_EltT* elts = nullptr;
+		// Robin Hood only, ( distance from the home slot + 1 ) of every slot, 0 means empty
+		uint8* dist = nullptr;
+		sizet capacity = 0;
+		// Amount of Deleted control bytes, they still count towards the load
+		sizet deleted = 0;
 	};
 public:
 
 	// Default constructor
 	unordered_map() {
-		_Malloc_Table(8); // just some random magic number
+		m_table = _Malloc_Table(8); // just some random magic number
 	};
 
 	// Constructor that initialize using a initializer list
@@ -122,82 +513,243 @@ public:
 		const Decimal additional_size = 1.0 / m_max_load_factor;
 		const sizet actual_reserved_size = list.size() * additional_size + 1; // +1 just to be safe, you know
 
-		_Malloc_Table(actual_reserved_size);
+		m_table = _Malloc_Table(actual_reserved_size);
 		_Load_Iterator(list.begin(), list.end());
 	}
 	
-	~unordered_map() {
-		// Destruct every destructable value
-		for (sizet i = 0; i < m_capacity; ++i) {
-			if (m_table[i].occupied) {
-				if (std::is_destructible<_KeyT>::value) {
-					m_table[i].key.~_KeyT();
-				}
-				if (std::is_destructible<_EltT>::value) {
-					m_table[i].elt.~_EltT();
-				}
-			}
+	// Copy constructor, a deep copy of both tables ( the old one too, while rehashing )
+	// The control bytes are one memcpy, so are the slots / elements if they're trivially copyable
+	unordered_map(const unordered_map& other) :
+		m_table(other._Copy_Table(other.m_table)), m_old_table(other._Copy_Table(other.m_old_table)),
+		m_migrate_pos(other.m_migrate_pos), m_migrate_step(other.m_migrate_step), m_rehash_step(other.m_rehash_step),
+		m_Hasher(other.m_Hasher), m_prob(other.m_prob), m_size(other.m_size), m_max_load_factor(other.m_max_load_factor) {
+
+	}
+
+	// Move constructor, just takes the tables
+	// other is left without a table, the next insert allocates one
+	unordered_map(unordered_map&& other) noexcept :
+		m_table(std::exchange(other.m_table, _Table())), m_old_table(std::exchange(other.m_old_table, _Table())),
+		m_migrate_pos(std::exchange(other.m_migrate_pos, 0)), m_migrate_step(other.m_migrate_step), m_rehash_step(other.m_rehash_step),
+		m_Hasher(other.m_Hasher), m_prob(other.m_prob), m_size(std::exchange(other.m_size, 0)), m_max_load_factor(other.m_max_load_factor) {
+
+	}
+
+	unordered_map& operator=(const unordered_map& other) {
+		if (this != &other) {
+			*this = unordered_map(other);
 		}
-		free(m_table);
-		m_table = nullptr;
-		m_capacity = 0;
-		m_size = 0;
+		return *this;
+	}
+
+	unordered_map& operator=(unordered_map&& other) noexcept {
+		if (this != &other) {
+			_Free_Table(m_table);
+			_Free_Table(m_old_table);
+			m_table = std::exchange(other.m_table, _Table());
+			m_old_table = std::exchange(other.m_old_table, _Table());
+			m_migrate_pos = std::exchange(other.m_migrate_pos, 0);
+			m_migrate_step = other.m_migrate_step;
+			m_rehash_step = other.m_rehash_step;
+			m_Hasher = other.m_Hasher;
+			m_prob = other.m_prob;
+			m_size = std::exchange(other.m_size, 0);
+			m_max_load_factor = other.m_max_load_factor;
+		}
+		return *this;
+	}
+
+	~unordered_map() {
+		_Free_Table(m_table);
+		_Free_Table(m_old_table);
 	}
 
 	// Basically the destructor
 	SSTD_INLINE void clear() {
-		for (sizet i = 0; i < m_capacity; ++i) {
-			if (m_table[i].occupied) {
-				if (std::is_destructible<_KeyT>::value) {
-					m_table[i].key.~_KeyT();
-				}
-				if (std::is_destructible<_EltT>::value) {
-					m_table[i].elt.~_EltT();
-				}
-			}
-		}
-		free(m_table);
-		m_table = nullptr;
-		m_capacity = 0;
+		_Free_Table(m_table);
+		_Free_Table(m_old_table);
+		m_migrate_pos = 0;
 		m_size = 0;
 	}
 
+	// Insert, or overwrite the element if the key already exists
 	SSTD_INLINE void insert(const _KeyT& key, const _EltT& elt) {
-		_Insert(key, elt); 
-		// Not going to do anything to it yet
+		_Insert_Or_Assign(key, m_Hasher(key), elt);
 	}
 	SSTD_INLINE void insert(const _KeyT& key, _EltT&& elt) {
-		_Insert(key, std::move(elt));
-		// Not going to do anything to it yet
+		_Insert_Or_Assign(key, m_Hasher(key), std::move(elt));
 	}
 	SSTD_INLINE void insert(const std::pair<_KeyT, _EltT>& pair) {
-		_Insert(pair.first, pair.second);
-		// Not going to do anything to it yet
+		_Insert_Or_Assign(pair.first, m_Hasher(pair.first), pair.second);
 	}
+	SSTD_INLINE void insert(std::pair<_KeyT, _EltT>&& pair) {
+		const sizet hash = m_Hasher(pair.first);
+		_Insert_Or_Assign(std::move(pair.first), hash, std::move(pair.second));
+	}
+	// The element is reset to _EltT() if the key already exists
 	SSTD_INLINE void insert(const _KeyT& key) {
-		_Insert(key);
-		// Not going to do anything to it yet
+		const std::pair<sizet, bool> res = _Find_Or_Prepare_Insert(key);
+		if (res.second) {
+			_Elt_At(res.first) = _EltT();
+		}
+		else {
+			_Construct_Elt(m_table, res.first);
+		}
+	}
+
+	// Construct the element from args, only if the key doesn't exist
+	// If it does, nothing is constructed and nothing is moved from, not even the key
+	// The bool is true if the element got inserted
+	template<typename... _Args>
+	SSTD_INLINE std::pair<iterator, bool> try_emplace(const _KeyT& key, _Args&&... args) {
+		return _Try_Emplace(key, std::forward<_Args>(args)...);
+	}
+	template<typename... _Args>
+	SSTD_INLINE std::pair<iterator, bool> try_emplace(_KeyT&& key, _Args&&... args) {
+		return _Try_Emplace(std::move(key), std::forward<_Args>(args)...);
+	}
+
+	// Assign obj to the element if the key exists, construct it from obj if it doesn't
+	// The bool is true if the element got inserted
+	template<typename _M>
+	SSTD_INLINE std::pair<iterator, bool> insert_or_assign(const _KeyT& key, _M&& obj) {
+		return _Insert_Or_Assign(key, m_Hasher(key), std::forward<_M>(obj));
+	}
+	template<typename _M>
+	SSTD_INLINE std::pair<iterator, bool> insert_or_assign(_KeyT&& key, _M&& obj) {
+		const sizet hash = m_Hasher(key);
+		return _Insert_Or_Assign(std::move(key), hash, std::forward<_M>(obj));
+	}
+
+	// Same as std::unordered_map::emplace, an existing key is left alone
+	// ( key, element ), a std::pair, or std::piecewise_construct with a tuple of arguments for each
+	// A key that is already a _KeyT goes straight into the slot, anything else builds a _KeyT first to hash it
+	template<typename _K, typename _E>
+	SSTD_INLINE std::pair<iterator, bool> emplace(_K&& key, _E&& elt) {
+		if constexpr (std::is_same<typename std::decay<_K>::type, _KeyT>::value) {
+			return _Try_Emplace(std::forward<_K>(key), std::forward<_E>(elt));
+		}
+		else {
+			return _Try_Emplace(_KeyT(std::forward<_K>(key)), std::forward<_E>(elt));
+		}
+	}
+	template<typename _K, typename _E>
+	SSTD_INLINE std::pair<iterator, bool> emplace(const std::pair<_K, _E>& pair) {
+		return emplace(pair.first, pair.second);
+	}
+	template<typename _K, typename _E>
+	SSTD_INLINE std::pair<iterator, bool> emplace(std::pair<_K, _E>&& pair) {
+		return emplace(std::move(pair.first), std::move(pair.second));
+	}
+	template<typename... _KArgs, typename... _EArgs>
+	SSTD_INLINE std::pair<iterator, bool> emplace(std::piecewise_construct_t, std::tuple<_KArgs...> key_args, std::tuple<_EArgs...> elt_args) {
+		return std::apply([&](auto&&... args) {
+			return _Try_Emplace(std::make_from_tuple<_KeyT>(std::move(key_args)), std::forward<decltype(args)>(args)...);
+		}, std::move(elt_args));
 	}
 
 	SSTD_INLINE void erase(const _KeyT& key) {
 		_Erase(key);
 	}
+	template<typename _K, typename _H = _Hash, typename = typename std::enable_if<_Is_Transparent<_H>::value>::type>
+	SSTD_INLINE void erase(const _K& key) {
+		_Erase(key);
+	}
+
+	SSTD_INLINE iterator find(const _KeyT& key) {
+		return _Search(key);
+	}
+	SSTD_INLINE const_iterator find(const _KeyT& key) const {
+		return _Search(key);
+	}
+	template<typename _K, typename _H = _Hash, typename = typename std::enable_if<_Is_Transparent<_H>::value>::type>
+	SSTD_INLINE iterator find(const _K& key) {
+		return _Search(key);
+	}
+	template<typename _K, typename _H = _Hash, typename = typename std::enable_if<_Is_Transparent<_H>::value>::type>
+	SSTD_INLINE const_iterator find(const _K& key) const {
+		return _Search(key);
+	}
+
+	SSTD_INLINE bool contains(const _KeyT& key) const {
+		return _Search_Index(key) != _End_Index();
+	}
+	template<typename _K, typename _H = _Hash, typename = typename std::enable_if<_Is_Transparent<_H>::value>::type>
+	SSTD_INLINE bool contains(const _K& key) const {
+		return _Search_Index(key) != _End_Index();
+	}
 
-	// Malloc / Realloc the additional _size
+	// Look up n keys at once, out[i] points to the element of keys[i], or is nullptr if it doesn't exist
+	// Returns how many keys were found
+	// The keys are hashed s_batch_window ahead of the probing and their home slots are prefetched,
+	// so the cache misses of the whole window are in flight together instead of one after another
+	SSTD_INLINE sizet find_batch(const _KeyT* keys, const sizet& n, _EltT** out) {
+		return _Find_Batch(keys, n, out);
+	}
+	SSTD_INLINE sizet find_batch(const _KeyT* keys, const sizet& n, const _EltT** out) const {
+		return _Find_Batch(keys, n, out);
+	}
+	template<typename _K, typename _H = _Hash, typename = typename std::enable_if<_Is_Transparent<_H>::value>::type>
+	SSTD_INLINE sizet find_batch(const _K* keys, const sizet& n, _EltT** out) {
+		return _Find_Batch(keys, n, out);
+	}
+	template<typename _K, typename _H = _Hash, typename = typename std::enable_if<_Is_Transparent<_H>::value>::type>
+	SSTD_INLINE sizet find_batch(const _K* keys, const sizet& n, const _EltT** out) const {
+		return _Find_Batch(keys, n, out);
+	}
+
+	// Same as calling insert(keys[i], elts[i]) for every i, with the same prefetching as find_batch
+	SSTD_INLINE void insert_batch(const _KeyT* keys, const _EltT* elts, const sizet& n) {
+		_Pipeline(keys, n, [&](const sizet& i, const sizet& hash) {
+			_Insert_Or_Assign(keys[i], hash, elts[i]);
+		});
+	}
+
+	// Make room for additional _size slots
+	// ( The table is rebuilt, since every key may land in another group )
 	SSTD_INLINE void reserve(const sizet& _size) {
-		if (m_table == nullptr) {
-			_Malloc_Table(_size);
+		_Finish_Migration();
+		if (m_table.slots == nullptr) {
+			m_table = _Malloc_Table(_size);
 		}
 		else {
-			_Realloc_Table(m_capacity + _size);
+			_Rehash(m_table.capacity + _size);
 		}
 	}
 
+	// Spread the rehash over the following inserts
+	// When the table grows, the old table stays next to the new one,
+	// and every insert / operator[] moves the next 'step' slots of the old table over
+	// ( at least as many as it takes to be done before the new table is full enough to grow again )
+	// 0 ( the default ) moves everything at once
+	SSTD_INLINE void set_rehash_step(const sizet& step) noexcept {
+		m_rehash_step = step;
+	}
+	SSTD_INLINE SSTD_CONSTEXPR sizet rehash_step() const noexcept {
+		return m_rehash_step;
+	}
+	// Are there still elements waiting in the old table
+	SSTD_INLINE SSTD_CONSTEXPR bool rehashing() const noexcept {
+		return m_old_table.slots != nullptr;
+	}
+
 	SSTD_INLINE SSTD_CONSTEXPR sizet size() const noexcept {
 		return m_size;
 	}
 	SSTD_INLINE SSTD_CONSTEXPR sizet capacity() const noexcept {
-		return m_capacity;
+		return m_table.capacity;
+	}
+	// Deleted slots, they count towards the load until the table gets rebuilt ( never any with Robin Hood )
+	SSTD_INLINE SSTD_CONSTEXPR sizet tombstones() const noexcept {
+		return m_table.deleted;
+	}
+	// The capacity a table gets when it's asked for n slots
+	static SSTD_INLINE SSTD_CONSTEXPR sizet slot_capacity(const sizet& n) noexcept {
+		return _Reduce::capacity(n);
+	}
+	// Bytes of one slot, with its control byte, and its element / distance if those live in their own arrays
+	static SSTD_INLINE SSTD_CONSTEXPR sizet slot_bytes() noexcept {
+		return sizeof(_Slot_T) + 1 + (s_split ? sizeof(_EltT) : 0) + (s_robin_hood ? 1 : 0);
 	}
 	SSTD_INLINE SSTD_CONSTEXPR sizet empty() const noexcept {
 		return m_size == 0;
@@ -205,219 +757,926 @@ public:
 
 	// Construct a empty value into the table if the key doesn't exist
 	SSTD_INLINE _EltT& operator[](const _KeyT& key) {
-		//_Print();
-		iterator ptr = _Search(key);
-		if (ptr != end()) {
-			return m_table[ptr.m_ind].elt;
-		}
-		iterator itr = _Insert(key, _EltT());
-		return m_table[itr.m_ind].elt;
+		return _Elt_At(_Try_Emplace(key).first.m_ind);
+	}
+	SSTD_INLINE _EltT& operator[](_KeyT&& key) {
+		return _Elt_At(_Try_Emplace(std::move(key)).first.m_ind);
 	}
 
 	// Straight up return
 	SSTD_INLINE const _EltT& operator[](const _KeyT& key) const noexcept {
-		return m_table[_Search(key).m_ind].elt;
+		return _Elt_At(_Search(key).m_ind);
 	}
 
 	// Mantain this below max_load_factor
 	SSTD_INLINE SSTD_CONSTEXPR Decimal load_factor() const {
-		return static_cast<Decimal>(m_size) / (m_capacity ? m_capacity : 1);
+		return static_cast<Decimal>(m_size) / (m_table.capacity ? m_table.capacity : 1);
+	}
+	SSTD_INLINE SSTD_CONSTEXPR Decimal max_load_factor() const noexcept {
+		return m_max_load_factor;
 	}
 
 	SSTD_INLINE SSTD_CONSTEXPR iterator begin() noexcept {
-		return iterator(this, 0);
+		return iterator(this, _Next_Full(0));
 	}
 	SSTD_INLINE SSTD_CONSTEXPR const_iterator begin() const noexcept {
-		return const_iterator(this, 0);
+		return const_iterator(this, _Next_Full(0));
 	}
 	SSTD_INLINE SSTD_CONSTEXPR iterator end() noexcept {
-		return iterator(this, m_capacity);
+		return iterator(this, _End_Index());
 	}
 	SSTD_INLINE SSTD_CONSTEXPR const_iterator end() const noexcept {
-		return const_iterator(this, m_capacity);
+		return const_iterator(this, _End_Index());
 	}
 
-	SSTD_INLINE SSTD_CONSTEXPR iterator cbegin() noexcept {
-		return const_iterator(this, 0);
+	SSTD_INLINE SSTD_CONSTEXPR const_iterator cbegin() const noexcept {
+		return const_iterator(this, _Next_Full(0));
+	}
+	SSTD_INLINE SSTD_CONSTEXPR const_iterator cend() const noexcept {
+		return const_iterator(this, _End_Index());
 	}
-	SSTD_INLINE SSTD_CONSTEXPR iterator cend() noexcept {
-		return const_iterator(this, m_capacity);
+
+	// Write the whole table to path ( see _Image_Header ), open_mapped serves lookups straight from that file
+	// Keys and elements are written byte by byte, so they have to be trivially copyable
+	// ( Pointers are saved as addresses, which mean nothing to another process )
+	// A pending incremental rehash is finished first
+	// Throws std::runtime_error if the file can't be written
+	SSTD_INLINE void save(const char* path) {
+		SSTD_STATIC_ASSERT(std::is_trivially_copyable<_KeyT>::value && std::is_trivially_copyable<_EltT>::value,
+			"Only trivially copyable keys and elements can be saved");
+		_Finish_Migration();
+		const _Image_Header header = _Make_Header(m_table.capacity, m_size, _Hash_Seed<_Hash>::get(m_Hasher));
+		std::FILE* file = std::fopen(path, "wb");
+		if (file == nullptr) {
+			throw std::runtime_error(std::string("Can't open ") + path);
+		}
+		bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+		sizet written = sizeof(header);
+		if (m_table.slots != nullptr) {
+			ok = ok && _Write_Section(file, written, m_table.ctrl, _Ctrl_Size(m_table.capacity));
+			ok = ok && _Write_Slots(file, written, m_table.slots);
+			if constexpr (s_split) {
+				ok = ok && _Write_Slots(file, written, m_table.elts);
+			}
+			if constexpr (s_robin_hood) {
+				ok = ok && _Write_Section(file, written, m_table.dist, m_table.capacity);
+			}
+		}
+		ok = std::fclose(file) == 0 && ok;
+		if (!ok) {
+			throw std::runtime_error(std::string("Can't write ") + path);
+		}
 	}
+
+	// Map a file written by save read only
+	// Nothing is copied or rebuilt, find / contains read the mapped slots directly,
+	// so only the pages the lookups touch are ever read from disk
+	// Throws std::runtime_error if the file wasn't saved by a map of this type with the same layout
+	// ( Defined in mapped_unordered_map.hpp, so the OS headers only come in for the files that map tables )
+	static mapped_unordered_map<_KeyT, _EltT, _Hash, _ProbT> open_mapped(const char* path);
+
+#if defined(SSTD_MAP_STATS)
+	// The counters since the map was built ( or reset_stats ), plus the tombstones and max displacement of the table right now
+	// Finding the max displacement walks the whole table
+	SSTD_INLINE unordered_map_stats stats() const {
+		unordered_map_stats res = m_stats;
+		res.tombstones = m_table.deleted;
+		for (sizet i = 0; i < m_table.capacity; ++i) {
+			if (_Ctrl::is_full(m_table.ctrl[i])) {
+				const sizet dist = _Displacement(m_table, i);
+				res.max_displacement = dist > res.max_displacement ? dist : res.max_displacement;
+			}
+		}
+		return res;
+	}
+
+	SSTD_INLINE void reset_stats() noexcept {
+		m_stats = unordered_map_stats();
+	}
+
+	// The stats, and then the state and displacement of every capacity / samples slot
+	SSTD_INLINE void debug_dump(std::ostream& out = std::cout, const sizet& samples = 64) const {
+		const unordered_map_stats res = stats();
+		out << "size " << m_size << ", capacity " << m_table.capacity << ", load factor " << load_factor()
+			<< ", tombstones " << res.tombstones << ", max displacement " << res.max_displacement << '\n';
+		out << "growths " << res.growths << ", rebuilds " << res.rebuilds << ", rehash time " << res.rehash_nanos << " ns\n";
+		out << "probes  hits  misses\n";
+		for (sizet i = 0; i < unordered_map_stats::buckets; ++i) {
+			if (res.hit_probes[i] || res.miss_probes[i]) {
+				out << (i + 1 == unordered_map_stats::buckets ? ">=" : "  ") << i << "  " << res.hit_probes[i] << "  " << res.miss_probes[i] << '\n';
+			}
+		}
+		const sizet step = samples && m_table.capacity > samples ? m_table.capacity / samples : 1;
+		for (sizet i = 0; i < m_table.capacity; i += step) {
+			out << "slot " << i << ": ";
+			if (_Ctrl::is_full(m_table.ctrl[i])) {
+				out << "full, displacement " << _Displacement(m_table, i) << '\n';
+			}
+			else {
+				out << (m_table.ctrl[i] == _Ctrl::Deleted ? "deleted\n" : "empty\n");
+			}
+		}
+	}
+#endif
 private:
-	_Map_Element* m_table = nullptr;
+	_Table m_table;
+	// The table we are migrating away from, while rehashing incrementally
+	_Table m_old_table;
+	// Every slot of m_old_table before this one has already been moved
+	sizet m_migrate_pos = 0;
+	// Slots moved per insert during this migration, m_rehash_step or more
+	sizet m_migrate_step = 0;
+	sizet m_rehash_step = 0;
 
-	const _Hash m_Hasher;
-	const _ProbT m_prob;
+	_Hash m_Hasher{};
+	_ProbT m_prob{};
 
+	// Elements in both tables
 	sizet m_size = 0;
-	sizet m_capacity = 0;
 
 	Decimal m_max_load_factor = 0.5;
 
-	SSTD_INLINE void _Malloc_Table(const sizet& memsize) {
-		m_capacity = memsize;
-		m_table = (_Map_Element*)malloc(sizeof(_Map_Element) * m_capacity);
-		for (sizet i = 0; i < m_capacity; ++i) {
-			m_table[i].occupied = false;
+	static SSTD_CONSTEXPR bool s_robin_hood = _Is_Robin_Hood<_ProbT>::value;
+	using _Reduce = typename _Probe_Reduce<_ProbT>::type;
+	// The largest distance _Table::dist can hold
+	static SSTD_CONSTEXPR uint32 s_max_dist = 255;
+	// How many keys ahead the batch functions hash and prefetch
+	static SSTD_CONSTEXPR sizet s_batch_window = 16;
+
+#if defined(SSTD_MAP_STATS)
+	// Lookups only read the table, but still count
+	mutable unordered_map_stats m_stats;
+#endif
+
+	SSTD_INLINE void _Stat_Probe(const bool hit, const sizet& probes) const noexcept {
+#if defined(SSTD_MAP_STATS)
+		const sizet bucket = probes < unordered_map_stats::buckets ? probes : unordered_map_stats::buckets - 1;
+		++(hit ? m_stats.hit_probes : m_stats.miss_probes)[bucket];
+#else
+		(void)hit;
+		(void)probes;
+#endif
+	}
+
+#if defined(SSTD_MAP_STATS)
+	// Groups ( slots for Robin Hood ) between the home of the element in slot ind and the slot
+	SSTD_INLINE sizet _Displacement(const _Table& tab, const sizet& ind) const {
+		const sizet hash = _Hash_Of(tab.slots[ind]);
+		if constexpr (s_robin_hood) {
+			return tab.dist[ind] - 1;
+		}
+		else {
+			const sizet groups = _Group_Count(tab);
+			for (sizet i = 0; i < groups; ++i) {
+				if (m_prob(hash, i, groups) == ind / _Group::width) {
+					return i;
+				}
+			}
+			return groups;
 		}
 	}
+#endif
+
+	// A read only map over a saved table, see mapped_unordered_map
+	unordered_map(const _Hash& hasher, const _Table& tab, const sizet& _size) :
+		m_table(tab), m_Hasher(hasher), m_size(_size) {
+
+	}
 
-	SSTD_INLINE void _Realloc_Table(const sizet& new_size) {
-		_Map_Element* tmp = (_Map_Element*)realloc(m_table, sizeof(_Map_Element) * new_size);
+	// Control bytes are padded to a full group, so a group load never reads past the array
+	static SSTD_INLINE SSTD_CONSTEXPR sizet _Ctrl_Size(const sizet& capacity) noexcept {
+		return (capacity + _Group::width - 1) / _Group::width * _Group::width;
+	}
+
+	static SSTD_INLINE SSTD_CONSTEXPR sizet _Group_Count(const _Table& tab) noexcept {
+		return _Ctrl_Size(tab.capacity) / _Group::width;
+	}
 
-		// Handle situations if there aren't enough memory to extend
-		if (tmp == nullptr) {
-			tmp = (_Map_Element*)malloc(sizeof(_Map_Element) * new_size);
-			std::copy(m_table, m_table + m_capacity, tmp);
-			// Has already copyed the old data to the new memory, so the old memory is useless
-			free(m_table);
+	SSTD_INLINE _Table _Malloc_Table(const sizet& memsize) const {
+		_Table tab;
+		tab.capacity = _Reduce::capacity(memsize);
+		tab.slots = (_Slot_T*)malloc(sizeof(_Slot_T) * tab.capacity);
+		if constexpr (s_split) {
+			tab.elts = (_EltT*)malloc(sizeof(_EltT) * tab.capacity);
 		}
-		m_table = tmp;
-		for (sizet i = m_capacity; i < new_size; ++i) {
-			m_table[i].occupied = false;
+		tab.ctrl = (int8*)malloc(_Ctrl_Size(tab.capacity));
+		std::memset(tab.ctrl, _Ctrl::Empty, tab.capacity);
+		std::memset(tab.ctrl + tab.capacity, _Ctrl::Sentinel, _Ctrl_Size(tab.capacity) - tab.capacity);
+		if constexpr (s_robin_hood) {
+			tab.dist = (uint8*)calloc(tab.capacity, sizeof(uint8));
 		}
-		m_capacity = new_size;
+		return tab;
 	}
 
-	template<typename _TE>
-	SSTD_INLINE iterator _Insert(const _KeyT& key, _TE&& elt) {
-		if (m_table == nullptr) {
-			_Malloc_Table(4);
-			// Yet another magic number
-			// ( Just kidding, set it to 4 so it will not trigger the reallocation until the 3rd insert )
+	// A copy of tab with the same capacity, so every key stays in the same slot
+	// Empty and deleted slots are copied too when it's a memcpy, they're never read
+	SSTD_INLINE _Table _Copy_Table(const _Table& tab) const {
+		_Table res;
+		if (tab.ctrl == nullptr) {
+			return res;
+		}
+		res.capacity = tab.capacity;
+		res.deleted = tab.deleted;
+		res.slots = (_Slot_T*)malloc(sizeof(_Slot_T) * tab.capacity);
+		res.ctrl = (int8*)malloc(_Ctrl_Size(tab.capacity));
+		std::memcpy(res.ctrl, tab.ctrl, _Ctrl_Size(tab.capacity));
+		if constexpr (s_robin_hood) {
+			res.dist = (uint8*)malloc(tab.capacity);
+			std::memcpy(res.dist, tab.dist, tab.capacity);
 		}
-		// Mantain load_factor below the max_load_factor
-		if (load_factor() >= m_max_load_factor) {
-			_Realloc_Table(m_capacity * 2);
+		if constexpr (std::is_trivially_copyable<_Slot_T>::value) {
+			std::memcpy(res.slots, tab.slots, sizeof(_Slot_T) * tab.capacity);
 		}
-		sizet i = 0;
-		while (i != m_capacity) {
-			// Get probing index
-			const sizet ind = m_prob(key, i, m_capacity, m_Hasher);
-			// That block is empty ( is available )
-			if (!m_table[ind].occupied) {
-				++m_size;
-				// Acquire it
-				m_table[ind].occupied = true;
+		else {
+			for (sizet i = 0; i < tab.capacity; ++i) {
+				if (_Ctrl::is_full(tab.ctrl[i])) {
+					new (&res.slots[i]) _Slot_T(tab.slots[i]);
+				}
+			}
+		}
+		if constexpr (s_split) {
+			res.elts = (_EltT*)malloc(sizeof(_EltT) * tab.capacity);
+			if constexpr (std::is_trivially_copyable<_EltT>::value) {
+				std::memcpy(res.elts, tab.elts, sizeof(_EltT) * tab.capacity);
+			}
+			else {
+				for (sizet i = 0; i < tab.capacity; ++i) {
+					if (_Ctrl::is_full(tab.ctrl[i])) {
+						new (&res.elts[i]) _EltT(tab.elts[i]);
+					}
+				}
+			}
+		}
+		return res;
+	}
 
-				// Construct it
-				m_table[ind].key = key;
-				new (&m_table[ind].elt) _EltT(elt);
+	// Free the memory without touching the elements
+	static SSTD_INLINE void _Release_Table(_Table& tab) noexcept {
+		free(tab.slots);
+		free(tab.elts);
+		free(tab.ctrl);
+		free(tab.dist);
+		tab = _Table();
+	}
 
-				return iterator(this, ind);
+	SSTD_INLINE void _Free_Table(_Table& tab) {
+		// Destruct every destructable value
+		for (sizet i = 0; i < tab.capacity; ++i) {
+			if (_Ctrl::is_full(tab.ctrl[i])) {
+				if (std::is_destructible<_KeyT>::value) {
+					tab.slots[i].key.~_KeyT();
+				}
+				if (std::is_destructible<_EltT>::value) {
+					_Destroy_Elt(tab, i);
+				}
 			}
-			// Or that block has the same key
-			else if (m_table[ind].key == key) {
-				// Construct it
-				new (&m_table[ind].elt) _EltT(std::move(elt));
+		}
+		_Release_Table(tab);
+	}
 
-				return iterator(this, ind);
+	// Build a new table and move every element into it
+	// Every key is probed again, since the amount of groups has changed
+	// With a rehash step, the old table is kept and emptied by the following inserts instead
+	SSTD_INLINE void _Rehash(const sizet& new_size) {
+		_Finish_Migration();
+		m_old_table = m_table;
+		m_table = _Malloc_Table(new_size);
+#if defined(SSTD_MAP_STATS)
+		++(m_table.capacity > m_old_table.capacity ? m_stats.growths : m_stats.rebuilds);
+#endif
+		m_migrate_pos = 0;
+		if (m_rehash_step == 0) {
+			_Finish_Migration();
+			return;
+		}
+		// The insert that grows the new table again comes after at most 'inserts' more, and every one of them moves a step first,
+		// so the step is big enough to be done by then, and growing never has to finish a migration in one go
+		const Decimal limit = m_table.capacity * m_max_load_factor;
+		const sizet inserts = limit > m_size ? static_cast<sizet>(limit - m_size) + 1 : 1;
+		const sizet needed = (m_old_table.capacity + inserts - 1) / inserts;
+		m_migrate_step = m_rehash_step > needed ? m_rehash_step : needed;
+	}
+
+	// Move slot i of the old table into m_table, and return where it went
+	// The old slot becomes Deleted, Robin Hood distances stay, so lookups in the old table still walk past it
+	SSTD_INLINE sizet _Migrate_Slot(const sizet& i) {
+		_Slot_T& slot = m_old_table.slots[i];
+		const sizet ind = _Claim_Slot(m_table, _Hash_Of(slot), s_max_dist);
+		SSTD_ASSERT(ind != m_table.capacity);
+		new (&m_table.slots[ind].key) _KeyT(std::move(slot.key));
+		_Construct_Elt(m_table, ind, std::move(_Elt(m_old_table, i)));
+		slot.key.~_KeyT();
+		_Destroy_Elt(m_old_table, i);
+		m_old_table.ctrl[i] = _Ctrl::Deleted;
+		return ind;
+	}
+
+	// Move the next 'step' slots of the old table
+	SSTD_INLINE void _Migrate(const sizet& step) {
+#if defined(SSTD_MAP_STATS)
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#endif
+		const sizet stop = m_old_table.capacity - m_migrate_pos > step ? m_migrate_pos + step : m_old_table.capacity;
+		for (; m_migrate_pos < stop; ++m_migrate_pos) {
+			if (_Ctrl::is_full(m_old_table.ctrl[m_migrate_pos])) {
+				_Migrate_Slot(m_migrate_pos);
 			}
-			++i;
 		}
-		// The table is full ( which won't happen, or something is really REALLY wrong)
-		return end();
+		if (m_migrate_pos == m_old_table.capacity) {
+			_Release_Table(m_old_table);
+			m_migrate_pos = 0;
+		}
+#if defined(SSTD_MAP_STATS)
+		m_stats.rehash_nanos += static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+#endif
+	}
+
+	SSTD_INLINE void _Finish_Migration() {
+		if (m_old_table.slots != nullptr) {
+			_Migrate(m_old_table.capacity);
+		}
 	}
 
-	// Insert default constructor
-	SSTD_INLINE iterator _Insert(const _KeyT& key) {
-		if (m_table == nullptr) {
-			_Malloc_Table(4);
+	// Grow before the insert that would push us over the max_load_factor
+	// If most of the load is Deleted slots, rebuilding at the same capacity is enough
+	SSTD_INLINE void _Reserve_One() {
+		if (m_table.slots == nullptr) {
+			m_table = _Malloc_Table(4);
 			// Yet another magic number
 			// ( Just kidding, set it to 4 so it will not trigger the reallocation until the 3rd insert )
+			return;
+		}
+		if (static_cast<Decimal>(m_size + m_table.deleted + 1) <= m_table.capacity * m_max_load_factor) {
+			return;
+		}
+		if (m_table.deleted > m_size) {
+			_Rehash(m_table.capacity);
+		}
+		else {
+			_Rehash(m_table.capacity * 2);
+		}
+	}
+
+	// Longest probe sequence an insert accepts before growing the table
+	// A long sequence in a mostly empty table comes from a bad hash, not from the load,
+	// and growing won't fix that, so only the hard limit applies there
+	SSTD_INLINE uint32 _Probe_Limit() const noexcept {
+		if constexpr (s_robin_hood) {
+			return load_factor() * 4 >= m_max_load_factor ? _ProbT::max_probe : s_max_dist;
+		}
+		return s_max_dist;
+	}
+
+	// Slot in the probe sequence of a key that isn't in the table yet,
+	// with its control byte already set, ready for the key and element to be constructed in
+	// ( Returns tab.capacity if there's no room within the probe limit )
+	SSTD_INLINE sizet _Claim_Slot(_Table& tab, const sizet& hash, const uint32 limit) {
+		const int8 h2 = _Ctrl::h2(hash);
+		if constexpr (s_robin_hood) {
+			sizet pos = m_prob(hash, 0, tab.capacity);
+			uint32 dist = 1;
+			// Walk past every element that is at least as far from its home as we are
+			while (tab.dist[pos] >= dist) {
+				pos = _Reduce::wrap(pos, 1, tab.capacity);
+				if (++dist > limit) {
+					return tab.capacity;
+				}
+			}
+			// Everything from pos to the next empty slot moves one slot further from home
+			sizet last = pos;
+			while (tab.dist[last]) {
+				if (tab.dist[last] >= limit) {
+					return tab.capacity;
+				}
+				last = _Reduce::wrap(last, 1, tab.capacity);
+			}
+			for (sizet j = last; j != pos;) {
+				const sizet prev = _Reduce::wrap(j, tab.capacity - 1, tab.capacity);
+				_Move_Slot(tab, prev, j);
+				tab.dist[j] = tab.dist[prev] + 1;
+				j = prev;
+			}
+			tab.dist[pos] = static_cast<uint8>(dist);
+			tab.ctrl[pos] = h2;
+			tab.slots[pos].set_hash(hash);
+			return pos;
+		}
+		else {
+			const sizet ind = _Find_Free(tab, hash);
+			if (ind == tab.capacity) {
+				return tab.capacity;
+			}
+			if (tab.ctrl[ind] == _Ctrl::Deleted) {
+				--tab.deleted;
+			}
+			tab.ctrl[ind] = h2;
+			tab.slots[ind].set_hash(hash);
+			return ind;
+		}
+	}
+
+	// Move the key and element of slot from into the ( unconstructed ) slot to
+	static SSTD_INLINE void _Move_Slot(_Table& tab, const sizet& from, const sizet& to) {
+		new (&tab.slots[to].key) _KeyT(std::move(tab.slots[from].key));
+		_Construct_Elt(tab, to, std::move(_Elt(tab, from)));
+		tab.slots[from].key.~_KeyT();
+		_Destroy_Elt(tab, from);
+		if constexpr (s_cache_hash) {
+			tab.slots[to].hash = tab.slots[from].hash;
+		}
+		tab.ctrl[to] = tab.ctrl[from];
+	}
+
+	// Hash of a key that is already in a table
+	SSTD_INLINE sizet _Hash_Of(const _Slot_T& slot) const {
+		if constexpr (s_cache_hash) {
+			return slot.hash;
+		}
+		else {
+			return m_Hasher(slot.key);
+		}
+	}
+
+	// The cached hash rejects most of the h2 matches before operator== runs
+	template<typename _K>
+	SSTD_INLINE bool _Slot_Equal(const _Slot_T& slot, const _K& key, const sizet& hash) const {
+		if constexpr (s_cache_hash) {
+			return slot.hash == hash && slot.key == key;
+		}
+		else {
+			return slot.key == key;
+		}
+	}
+
+	// The element of slot i, wherever the storage layout keeps it
+	// Without element storage every slot shares one element, it's empty anyway
+	static SSTD_INLINE _EltT& _Elt(_Table& tab, const sizet& i) noexcept {
+		if constexpr (s_no_elt) {
+			static _EltT elt;
+			return elt;
+		}
+		else if constexpr (s_split) {
+			return tab.elts[i];
+		}
+		else {
+			return tab.slots[i].elt;
+		}
+	}
+	static SSTD_INLINE const _EltT& _Elt(const _Table& tab, const sizet& i) noexcept {
+		return _Elt(const_cast<_Table&>(tab), i);
+	}
+
+	template<typename... _Args>
+	static SSTD_INLINE void _Construct_Elt(_Table& tab, const sizet& i, _Args&&... args) {
+		if constexpr (!s_no_elt) {
+			new (&_Elt(tab, i)) _EltT(std::forward<_Args>(args)...);
 		}
-		// Mantain load_factor below the max_load_factor
-		if (load_factor() >= m_max_load_factor) {
-			_Realloc_Table(m_capacity * 2);
+	}
+	static SSTD_INLINE void _Destroy_Elt(_Table& tab, const sizet& i) noexcept {
+		if constexpr (!s_no_elt) {
+			_Elt(tab, i).~_EltT();
 		}
-		sizet i = 0;
-		while (i != m_capacity) {
-			// Get probing index
-			const sizet ind = m_prob(key, i, m_capacity, m_Hasher);
-			// That block is empty ( is available )
-			if (!m_table[ind].occupied) {
-				++m_size;
-				// Acquire it
-				m_table[ind].occupied = true;
+	}
 
-				// Construct it
-				m_table[ind].key = key;
-				new (&m_table[ind].elt) _EltT();
+	// First Empty or Deleted slot in the probe sequence of the key
+	// ( Returns tab.capacity if the probe sequence has no room left )
+	SSTD_INLINE sizet _Find_Free(const _Table& tab, const sizet& hash) const {
+		const sizet groups = _Group_Count(tab);
+		for (sizet i = 0; i < groups; ++i) {
+			const sizet base = m_prob(hash, i, groups) * _Group::width;
+			const uint64 mask = _Group(tab.ctrl + base).match_empty_or_deleted();
+			if (mask) {
+				return base + (_Count_Trailing_Zeros(mask) >> _Group::shift);
+			}
+		}
+		return tab.capacity;
+	}
 
-				return iterator(this, ind);
+	// Index of the key, or tab.capacity if the key isn't in the table
+	// Only the slots whose control byte matches the 7 bit hash are compared,
+	// and a group with an Empty slot ends the search
+	template<typename _K>
+	SSTD_INLINE sizet _Find_Index(const _Table& tab, const _K& key, const sizet& hash) const {
+		if constexpr (s_robin_hood) {
+			return _Robin_Hood_Find_Index(tab, key, hash);
+		}
+		const sizet groups = _Group_Count(tab);
+		const int8 h2 = _Ctrl::h2(hash);
+		for (sizet i = 0; i < groups; ++i) {
+			const sizet base = m_prob(hash, i, groups) * _Group::width;
+			const _Group group(tab.ctrl + base);
+			for (uint64 mask = group.match(h2); mask; mask &= mask - 1) {
+				const sizet ind = base + (_Count_Trailing_Zeros(mask) >> _Group::shift);
+				if (_Slot_Equal(tab.slots[ind], key, hash)) {
+					_Stat_Probe(true, i + 1);
+					return ind;
+				}
 			}
-			// Or that block has the same key
-			else if (m_table[ind].key == key) {
-				// Construct it
-				new (&m_table[ind].elt) _EltT();
+			if (group.match_empty()) {
+				_Stat_Probe(false, i + 1);
+				return tab.capacity;
+			}
+		}
+		_Stat_Probe(false, groups);
+		return tab.capacity;
+	}
 
-				return iterator(this, ind);
+	// Walk the run from the home slot, until we reach an element that is closer to its home than we are
+	// ( The key would have taken that slot on insert )
+	template<typename _K>
+	SSTD_INLINE sizet _Robin_Hood_Find_Index(const _Table& tab, const _K& key, const sizet& hash) const {
+		if (tab.slots == nullptr) {
+			return tab.capacity;
+		}
+		const int8 h2 = _Ctrl::h2(hash);
+		sizet pos = m_prob(hash, 0, tab.capacity);
+		uint32 dist = 1;
+		for (; tab.dist[pos] >= dist; ++dist) {
+			if (tab.ctrl[pos] == h2 && _Slot_Equal(tab.slots[pos], key, hash)) {
+				_Stat_Probe(true, dist);
+				return pos;
 			}
-			++i;
+			pos = _Reduce::wrap(pos, 1, tab.capacity);
 		}
-		// The table is full ( which won't happen, or something is really REALLY wrong)
-		return end();
+		_Stat_Probe(false, dist);
+		return tab.capacity;
 	}
 
-	SSTD_INLINE iterator _Search(const _KeyT& key) {
-		sizet i = 0;
-		while (i != m_capacity) {
-			// Get probing index
-			const sizet ind = m_prob(key, i, m_capacity, m_Hasher);
-			if (m_table[ind].key == key) {
-				return iterator(this, ind);
+	// Find the key, or the slot where the key should go
+	// The bool is true if the key is already in the table
+	// A key that's already there is left alone, so its index is across both tables ( see _Slot )
+	// Only a new key can grow the table or move the migration along, and it always lands in m_table
+	// A new key is constructed from key ( moved if it's an rvalue ), the element is left to the caller
+	template<typename _K>
+	SSTD_INLINE std::pair<sizet, bool> _Find_Or_Prepare_Insert(_K&& key) {
+		const sizet hash = m_Hasher(key);
+		return _Find_Or_Prepare_Insert(std::forward<_K>(key), hash);
+	}
+	template<typename _K>
+	SSTD_INLINE std::pair<sizet, bool> _Find_Or_Prepare_Insert(_K&& key, const sizet& hash) {
+		// Search first, growing on a key that's already there would move every element for nothing
+		if (m_table.slots != nullptr) {
+			const sizet ind = _Search_Index(key, hash);
+			if (ind != _End_Index()) {
+				return { ind, true };
 			}
-			else if (!m_table[ind].occupied) {
-				return end();
+		}
+		if (m_old_table.slots != nullptr) {
+			_Migrate(m_migrate_step);
+		}
+		_Reserve_One();
+		sizet free_ind = _Claim_Slot(m_table, hash, _Probe_Limit());
+		if (free_ind == m_table.capacity) {
+			// The probe sequence didn't reach any free slot, the table has to grow
+			_Rehash(m_table.capacity * 2);
+			_Finish_Migration();
+			free_ind = _Claim_Slot(m_table, hash, s_max_dist);
+			if (free_ind == m_table.capacity) {
+				// Robin Hood, when a lot of keys share the same hash,
+				// or a probe sequence that doesn't reach every group ( say quadratic probing ) and only runs into full ones
+				throw std::overflow_error("Probe distance overflow, check the hash function");
 			}
-			++i;
 		}
+		new (&m_table.slots[free_ind].key) _KeyT(std::forward<_K>(key));
+		++m_size;
+		return { free_ind, false };
+	}
 
-		// Didn't find
-		return end();
+	template<typename _K, typename... _Args>
+	SSTD_INLINE std::pair<iterator, bool> _Try_Emplace(_K&& key, _Args&&... args) {
+		const std::pair<sizet, bool> res = _Find_Or_Prepare_Insert(std::forward<_K>(key));
+		if (!res.second) {
+			_Construct_Elt(m_table, res.first, std::forward<_Args>(args)...);
+		}
+		return { iterator(this, res.first), !res.second };
 	}
 
-	// A const version that returns const_iterator
-	SSTD_INLINE const_iterator _Search(const _KeyT key) const {
-		sizet i = 0;
-		while (i != m_capacity) {
-			const sizet ind = m_prob(key, i, m_capacity, m_Hasher);
-			if (m_table[ind].key == key) {
-				return const_iterator(this, ind);
+	template<typename _K, typename _M>
+	SSTD_INLINE std::pair<iterator, bool> _Insert_Or_Assign(_K&& key, const sizet& hash, _M&& obj) {
+		const std::pair<sizet, bool> res = _Find_Or_Prepare_Insert(std::forward<_K>(key), hash);
+		if (res.second) {
+			_Elt_At(res.first) = std::forward<_M>(obj);
+		}
+		else {
+			_Construct_Elt(m_table, res.first, std::forward<_M>(obj));
+		}
+		return { iterator(this, res.first), !res.second };
+	}
+
+	// Index of the key across both tables ( see _Slot ), or _End_Index()
+	// ( _K is either _KeyT or a type the transparent hash accepts )
+	template<typename _K>
+	SSTD_INLINE sizet _Search_Index(const _K& key) const {
+		return _Search_Index(key, m_Hasher(key));
+	}
+	template<typename _K>
+	SSTD_INLINE sizet _Search_Index(const _K& key, const sizet& hash) const {
+		const sizet ind = _Find_Index(m_table, key, hash);
+		if (ind != m_table.capacity) {
+			return ind;
+		}
+		if (m_old_table.slots != nullptr) {
+			const sizet old_ind = _Find_Index(m_old_table, key, hash);
+			if (old_ind != m_old_table.capacity) {
+				return m_table.capacity + old_ind;
 			}
-			else if (!m_table[ind].occupied) {
-				return end();
+		}
+		return _End_Index();
+	}
+
+	template<typename _K>
+	SSTD_INLINE iterator _Search(const _K& key) {
+		return iterator(this, _Search_Index(key));
+	}
+
+	// A const version that returns const_iterator
+	template<typename _K>
+	SSTD_INLINE const_iterator _Search(const _K& key) const {
+		return const_iterator(this, _Search_Index(key));
+	}
+
+	// Pull the control bytes and slots a lookup of hash starts at into the cache
+	SSTD_INLINE void _Prefetch_Home(const _Table& tab, const sizet& hash) const noexcept {
+		if (tab.slots == nullptr) {
+			return;
+		}
+		if constexpr (s_robin_hood) {
+			const sizet home = m_prob(hash, 0, tab.capacity);
+			_Prefetch(tab.dist + home);
+			_Prefetch(tab.ctrl + home);
+			_Prefetch(tab.slots + home);
+		}
+		else {
+			const sizet home = m_prob(hash, 0, _Group_Count(tab)) * _Group::width;
+			_Prefetch(tab.ctrl + home);
+			_Prefetch(tab.slots + home);
+		}
+	}
+
+	// Call func(i, hash of keys[i]) for every key in order,
+	// while the key s_batch_window ahead gets hashed and prefetched
+	// func may grow the table, a prefetch of the old table is then just wasted
+	template<typename _K, typename _Func>
+	SSTD_INLINE void _Pipeline(const _K* keys, const sizet& n, _Func&& func) const {
+		sizet hashes[s_batch_window];
+		for (sizet i = 0; i < n && i < s_batch_window; ++i) {
+			hashes[i] = m_Hasher(keys[i]);
+			_Prefetch_Home(m_table, hashes[i]);
+		}
+		for (sizet i = 0; i < n; ++i) {
+			sizet& hash = hashes[i % s_batch_window];
+			const sizet cur = hash;
+			if (i + s_batch_window < n) {
+				hash = m_Hasher(keys[i + s_batch_window]);
+				_Prefetch_Home(m_table, hash);
 			}
-			++i;
+			func(i, cur);
 		}
-		return end();
+	}
+
+	template<typename _K, typename _Out>
+	SSTD_INLINE sizet _Find_Batch(const _K* keys, const sizet& n, _Out** out) const {
+		sizet found = 0;
+		_Pipeline(keys, n, [&](const sizet& i, const sizet& hash) {
+			const sizet ind = _Search_Index(keys[i], hash);
+			if (ind == _End_Index()) {
+				out[i] = nullptr;
+			}
+			else {
+				out[i] = const_cast<_Out*>(&_Elt_At(ind));
+				++found;
+			}
+		});
+		return found;
 	}
 
 	// Erase the key
-	SSTD_INLINE void _Erase(const _KeyT& key) {
-		sizet i = 0;
-		while (i != m_capacity) {
-			const sizet ind = m_prob(key, i, m_capacity, m_Hasher);
-			if (m_table[ind].key == key && m_table[ind].occupied) {
-				m_table[ind].occupied = false;
-				if (std::is_destructible<_EltT>::value) {
-					m_table[ind].elt.~_EltT();
+	template<typename _K>
+	SSTD_INLINE void _Erase(const _K& key) {
+		_Erase(key, m_Hasher(key));
+	}
+	template<typename _K>
+	SSTD_INLINE void _Erase(const _K& key, const sizet& hash) {
+		const sizet ind = _Find_Index(m_table, key, hash);
+		if (ind != m_table.capacity) {
+			_Erase_At(m_table, ind);
+			return;
+		}
+		if (m_old_table.slots != nullptr) {
+			const sizet old_ind = _Find_Index(m_old_table, key, hash);
+			if (old_ind != m_old_table.capacity) {
+				// The old table is never probed for a free slot again, so just leave a Deleted slot there
+				_Destroy_Elt(m_old_table, old_ind);
+				m_old_table.slots[old_ind].key.~_KeyT();
+				m_old_table.ctrl[old_ind] = _Ctrl::Deleted;
+				--m_size;
+			}
+		}
+	}
+
+	SSTD_INLINE void _Erase_At(_Table& tab, const sizet& ind) {
+		if (std::is_destructible<_EltT>::value) {
+			_Destroy_Elt(tab, ind);
+		}
+		if (std::is_destructible<_KeyT>::value) {
+			tab.slots[ind].key.~_KeyT();
+		}
+		--m_size;
+		if constexpr (s_robin_hood) {
+			// Backward shift, pull the rest of the run one slot closer to home
+			sizet hole = ind;
+			for (sizet next = _Reduce::wrap(hole, 1, tab.capacity); tab.dist[next] > 1; next = _Reduce::wrap(next, 1, tab.capacity)) {
+				_Move_Slot(tab, next, hole);
+				tab.dist[hole] = tab.dist[next] - 1;
+				hole = next;
+			}
+			tab.ctrl[hole] = _Ctrl::Empty;
+			tab.dist[hole] = 0;
+			return;
+		}
+		// A lookup walking through this group stops here anyway if it has an Empty slot,
+		// so the slot can go back to Empty without breaking any probe sequence
+		const sizet base = ind / _Group::width * _Group::width;
+		if (_Group(tab.ctrl + base).match_empty()) {
+			tab.ctrl[ind] = _Ctrl::Empty;
+		}
+		else {
+			tab.ctrl[ind] = _Ctrl::Deleted;
+			++tab.deleted;
+		}
+	}
+
+	// Iterators index both tables, m_table first and then m_old_table
+	SSTD_INLINE SSTD_CONSTEXPR sizet _End_Index() const noexcept {
+		return m_table.capacity + m_old_table.capacity;
+	}
+	SSTD_INLINE const _KeyT& _Key_At(const sizet& ind) const noexcept {
+		return ind < m_table.capacity ? m_table.slots[ind].key : m_old_table.slots[ind - m_table.capacity].key;
+	}
+	SSTD_INLINE _EltT& _Elt_At(const sizet& ind) noexcept {
+		return ind < m_table.capacity ? _Elt(m_table, ind) : _Elt(m_old_table, ind - m_table.capacity);
+	}
+	SSTD_INLINE const _EltT& _Elt_At(const sizet& ind) const noexcept {
+		return ind < m_table.capacity ? _Elt(m_table, ind) : _Elt(m_old_table, ind - m_table.capacity);
+	}
+
+	// First full slot at or after ind
+	SSTD_INLINE sizet _Next_Full(const sizet& ind) const noexcept {
+		if (ind < m_table.capacity) {
+			const sizet res = _Next_Full(m_table, ind);
+			if (res != m_table.capacity) {
+				return res;
+			}
+		}
+		const sizet old_ind = ind > m_table.capacity ? ind - m_table.capacity : 0;
+		return m_table.capacity + (old_ind < m_old_table.capacity ? _Next_Full(m_old_table, old_ind) : m_old_table.capacity);
+	}
+
+	// A group of control bytes at a time, the empty ones never get looked at one by one
+	// ( Returns tab.capacity if there's no full slot left, the Sentinel padding is never full )
+	static SSTD_INLINE sizet _Next_Full(const _Table& tab, const sizet& ind) noexcept {
+		sizet base = ind / _Group::width * _Group::width;
+		// The slots before ind in the first group don't count
+		uint64 mask = _Group(tab.ctrl + base).match_full() & (~uint64(0) << ((ind - base) << _Group::shift));
+		while (mask == 0) {
+			base += _Group::width;
+			if (base >= tab.capacity) {
+				return tab.capacity;
+			}
+			mask = _Group(tab.ctrl + base).match_full();
+		}
+		return base + (_Count_Trailing_Zeros(mask) >> _Group::shift);
+	}
+
+	// Header of a saved table, the offsets of the sections follow from the capacity ( see _Image_Sections )
+	static SSTD_INLINE _Image_Header _Make_Header(const sizet& capacity, const sizet& _size, const uint64& seed) noexcept {
+		_Image_Header header;
+		std::memset(&header, 0, sizeof(header));
+		std::memcpy(header.magic, "SSTDMAP", 8);
+		header.version_ = _Image_Header::version;
+		header.probe_id = _Probe_Id<_ProbT>::value;
+		header.capacity = capacity;
+		header.size = _size;
+		header.seed = seed;
+		header.group_width = _Group::width;
+		header.sizet_size = sizeof(sizet);
+		header.key_size = sizeof(_KeyT);
+		header.elt_size = sizeof(_EltT);
+		header.slot_size = sizeof(_Slot_T);
+		header.flags = (s_cache_hash ? 1 : 0) | (s_split ? 2 : 0) | (s_robin_hood ? 4 : 0);
+		sizet sections[4];
+		header.file_size = capacity ? _Image_Sections(capacity, sections) : sizeof(_Image_Header);
+		return header;
+	}
+
+	// Offsets of the control bytes, slots, elements and distances in a saved table, returns the file size
+	static SSTD_INLINE sizet _Image_Sections(const sizet& capacity, sizet (&sections)[4]) noexcept {
+		SSTD_STATIC_ASSERT(alignof(_Slot_T) <= _Image_Header::align && alignof(_EltT) <= _Image_Header::align,
+			"Over aligned slots can't be saved");
+		sizet pos = _Image_Header::round(sizeof(_Image_Header));
+		sections[0] = pos;
+		pos = _Image_Header::round(pos + _Ctrl_Size(capacity));
+		sections[1] = pos;
+		pos = _Image_Header::round(pos + sizeof(_Slot_T) * capacity);
+		sections[2] = pos;
+		if constexpr (s_split) {
+			pos = _Image_Header::round(pos + sizeof(_EltT) * capacity);
+		}
+		sections[3] = pos;
+		if constexpr (s_robin_hood) {
+			pos += capacity;
+		}
+		return pos;
+	}
+
+	// Pad the file to the next section
+	static SSTD_INLINE bool _Write_Padding(std::FILE* file, sizet& written) {
+		static const char zeros[_Image_Header::align] = {};
+		const sizet pad = _Image_Header::round(written) - written;
+		written += pad;
+		return pad == 0 || std::fwrite(zeros, 1, pad, file) == pad;
+	}
+
+	static SSTD_INLINE bool _Write_Section(std::FILE* file, sizet& written, const void* data, const sizet& size) {
+		if (!_Write_Padding(file, written)) {
+			return false;
+		}
+		written += size;
+		return std::fwrite(data, 1, size, file) == size;
+	}
+
+	// The slots ( or elements ) of m_table, with every slot that isn't full zeroed,
+	// so whatever was left in that memory doesn't end up in the file
+	template<typename T>
+	SSTD_INLINE bool _Write_Slots(std::FILE* file, sizet& written, const T* data) const {
+		SSTD_CONSTEXPR sizet chunk = sizeof(T) < 4096 ? 4096 / sizeof(T) : 1;
+		T* buffer = (T*)malloc(sizeof(T) * chunk);
+		bool ok = buffer != nullptr && _Write_Padding(file, written);
+		for (sizet i = 0; ok && i < m_table.capacity; i += chunk) {
+			const sizet count = m_table.capacity - i < chunk ? m_table.capacity - i : chunk;
+			for (sizet j = 0; j < count; ++j) {
+				if (_Ctrl::is_full(m_table.ctrl[i + j])) {
+					std::memcpy(buffer + j, data + i + j, sizeof(T));
 				}
-				if (std::is_destructible<_KeyT>::value) {
-					m_table[ind].key.~_KeyT();
+				else {
+					std::memset(buffer + j, 0, sizeof(T));
 				}
-				--m_size;
-				return;
 			}
-			++i;
+			written += sizeof(T) * count;
+			ok = std::fwrite(buffer, sizeof(T), count, file) == count;
+		}
+		free(buffer);
+		return ok;
+	}
+
+	// The table of a mapped file of file_size bytes at data, checked against the header of this map type
+	static SSTD_INLINE _Table _Open_Image(const uint8* data, const sizet& file_size, _Hash& hasher, sizet& _size) {
+		_Image_Header header;
+		if (file_size < sizeof(header)) {
+			throw std::runtime_error("Not a saved unordered_map");
+		}
+		std::memcpy(&header, data, sizeof(header));
+		if (std::memcmp(header.magic, "SSTDMAP", 8) != 0 || header.version_ != _Image_Header::version) {
+			throw std::runtime_error("Not a saved unordered_map");
+		}
+		hasher = _Make_Hash<_Hash>(header.seed);
+		const _Image_Header expected = _Make_Header(static_cast<sizet>(header.capacity), 0, 0);
+		if (header.probe_id != expected.probe_id || header.group_width != expected.group_width ||
+			header.sizet_size != expected.sizet_size || header.key_size != expected.key_size ||
+			header.elt_size != expected.elt_size || header.slot_size != expected.slot_size ||
+			header.flags != expected.flags || _Hash_Seed<_Hash>::get(hasher) != header.seed) {
+			throw std::runtime_error("The saved unordered_map has a different layout or probing");
+		}
+		if (header.file_size != expected.file_size || file_size < header.file_size ||
+			(header.capacity && _Reduce::capacity(static_cast<sizet>(header.capacity)) != header.capacity)) {
+			throw std::runtime_error("The saved unordered_map is truncated or corrupted");
+		}
+		_size = static_cast<sizet>(header.size);
+		_Table tab;
+		if (header.capacity == 0) {
+			return tab;
 		}
+		// Never written through, every path that writes needs a non const map
+		uint8* base = const_cast<uint8*>(data);
+		sizet sections[4];
+		tab.capacity = static_cast<sizet>(header.capacity);
+		_Image_Sections(tab.capacity, sections);
+		tab.ctrl = reinterpret_cast<int8*>(base + sections[0]);
+		tab.slots = reinterpret_cast<_Slot_T*>(base + sections[1]);
+		if constexpr (s_split) {
+			tab.elts = reinterpret_cast<_EltT*>(base + sections[2]);
+		}
+		if constexpr (s_robin_hood) {
+			tab.dist = base + sections[3];
+		}
+		return tab;
 	}
 
 	// Load an iterator into the table
 	template<typename _Iter>
 	SSTD_INLINE void _Load_Iterator(_Iter _Begin, _Iter _End) {
 		for (; _Begin != _End; ++_Begin) {
-			_Insert(_Begin->first, _Begin->second);
+			_Insert_Or_Assign(_Begin->first, m_Hasher(_Begin->first), _Begin->second);
 		}
 	}
 };
@@ -437,23 +1696,30 @@ template<
 class _Unordered_Map_Iterator : public forward_iterator<std::pair<_KeyT, _EltT> > {
 	friend class unordered_map<_KeyT, _EltT, _Hash, _ProbT>;
 public:
+	// Straight into the slot, nothing gets copied
+	using reference = std::pair<const _KeyT&, _EltT&>;
+	using pointer = _Arrow_Proxy<reference>;
+
 	_Unordered_Map_Iterator(unordered_map<_KeyT, _EltT, _Hash, _ProbT>* _map, sizet ind) :
 		m_map(_map), m_ind(ind) {
 
 	}
 
 	SSTD_INLINE _Unordered_Map_Iterator& operator++() noexcept {
-		do { this->m_ind++; } while (m_ind < m_map->m_capacity && m_map->m_table[m_ind].available);
+		m_ind = m_map->_Next_Full(m_ind + 1);
 		return *this;
 	}
 	SSTD_INLINE _Unordered_Map_Iterator operator++(int) noexcept {
 		_Unordered_Map_Iterator tmp = *this;
-		do { this->m_ind++; } while (m_ind < m_map->m_capacity && !m_map->m_table[m_ind].occupied);
+		m_ind = m_map->_Next_Full(m_ind + 1);
 		return tmp;
 	}
 
-	SSTD_INLINE std::pair<_KeyT, _EltT> operator*() noexcept {
-		return { this->m_map->m_table[m_ind].key, this->m_map->m_table[m_ind].elt };
+	SSTD_INLINE reference operator*() const noexcept {
+		return { this->m_map->_Key_At(m_ind), this->m_map->_Elt_At(m_ind) };
+	}
+	SSTD_INLINE pointer operator->() const noexcept {
+		return { **this };
 	}
 
 	SSTD_INLINE bool operator==(const _Unordered_Map_Iterator& other) const noexcept {
@@ -484,6 +1750,9 @@ class _Unordered_Map_Const_Iterator : public const_forward_iterator<std::pair<_K
 	friend class unordered_map<_KeyT, _EltT, _Hash, _ProbT>;
 	friend class _Unordered_Map_Iterator<_KeyT, _EltT, _Hash, _ProbT>;
 public:
+	using reference = std::pair<const _KeyT&, const _EltT&>;
+	using pointer = _Arrow_Proxy<reference>;
+
 	_Unordered_Map_Const_Iterator(const unordered_map<_KeyT, _EltT, _Hash, _ProbT>* _map, sizet ind) :
 		m_map(_map), m_ind(ind) {
 
@@ -494,17 +1763,20 @@ public:
 	}
 
 	SSTD_INLINE _Unordered_Map_Const_Iterator& operator++() noexcept {
-		do { this->m_ind++; } while (m_ind < m_map->m_capacity && m_map->m_table[m_ind].available);
+		m_ind = m_map->_Next_Full(m_ind + 1);
 		return *this;
 	}
 	SSTD_INLINE _Unordered_Map_Const_Iterator operator++(int) noexcept {
 		_Unordered_Map_Const_Iterator tmp = *this;
-		do { this->m_ind++; } while (m_ind < m_map->m_capacity && !m_map->m_table[m_ind].occupied);
+		m_ind = m_map->_Next_Full(m_ind + 1);
 		return tmp;
 	}
 
-	SSTD_INLINE std::pair<_KeyT, _EltT> operator*() const noexcept {
-		return { this->m_map->m_table[m_ind].key, this->m_map->m_table[m_ind].elt };
+	SSTD_INLINE reference operator*() const noexcept {
+		return { this->m_map->_Key_At(m_ind), this->m_map->_Elt_At(m_ind) };
+	}
+	SSTD_INLINE pointer operator->() const noexcept {
+		return { **this };
 	}
 
 	SSTD_INLINE bool operator==(const _Unordered_Map_Const_Iterator& other) const noexcept {
@@ -0,0 +1,305 @@
+#ifndef SSTD_UNORDERED_SET_INCLUDED
+#define SSTD_UNORDERED_SET_INCLUDED
+
+#include "core.hpp"
+#include "Iterator.hpp"
+#include "unordered_map.hpp"
+
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+
+SSTD_BEGIN
+
+// The element of the map under a set, empty so the map keeps nothing but the keys ( see unordered_map::s_no_elt )
+struct _Set_Element {};
+
+template<typename _KeyT, typename _Hash, typename _ProbT>
+class _Unordered_Set_Iterator;
+
+// sstd::unordered_map without the elements
+// Same control bytes, probing and rehashing, the slots just hold the keys
+// ( A set of uint64 takes 8 bytes + 1 control byte per slot )
+//
+// merge / intersect_with / contains_all work on the two tables directly,
+// one group of slots at a time: the full slots of a group come out of one SIMD compare,
+// and all of their keys get prefetched in the other table before any of them is probed
+
+template<
+	typename _KeyT,	// Key type
+	typename _Hash = _Default_Hash<_KeyT>, // Hash function
+	typename _ProbT = _Double_Hash_Prob<_KeyT, _Hash> // probing function
+>
+class unordered_set {
+public:
+	friend class _Unordered_Set_Iterator<_KeyT, _Hash, _ProbT>;
+	using map_type = unordered_map<_KeyT, _Set_Element, _Hash, _ProbT>;
+	// The keys can't be changed in place, so both iterators are const
+	using iterator = _Unordered_Set_Iterator<_KeyT, _Hash, _ProbT>;
+	using const_iterator = _Unordered_Set_Iterator<_KeyT, _Hash, _ProbT>;
+private:
+	using _Table = typename map_type::_Table;
+	using _Slot_T = typename map_type::_Slot_T;
+public:
+
+	// Default constructor
+	unordered_set() SSTD_DEFAULT;
+
+	// Constructor that initialize using a initializer list
+	unordered_set(std::initializer_list<_KeyT> list) {
+		reserve(list.size() * 2);
+		for (const _KeyT& key : list) {
+			insert(key);
+		}
+	}
+
+	SSTD_INLINE void clear() {
+		m_map.clear();
+	}
+
+	// The bool is true if the key got inserted
+	SSTD_INLINE std::pair<iterator, bool> insert(const _KeyT& key) {
+		return _Insert(key);
+	}
+	SSTD_INLINE std::pair<iterator, bool> insert(_KeyT&& key) {
+		return _Insert(std::move(key));
+	}
+
+	// Build the key from args, then insert it
+	template<typename... _Args>
+	SSTD_INLINE std::pair<iterator, bool> emplace(_Args&&... args) {
+		return _Insert(_KeyT(std::forward<_Args>(args)...));
+	}
+
+	SSTD_INLINE void erase(const _KeyT& key) {
+		m_map.erase(key);
+	}
+	template<typename _K, typename _H = _Hash, typename = typename std::enable_if<_Is_Transparent<_H>::value>::type>
+	SSTD_INLINE void erase(const _K& key) {
+		m_map.erase(key);
+	}
+
+	SSTD_INLINE iterator find(const _KeyT& key) const {
+		return iterator(this, m_map._Search_Index(key));
+	}
+	template<typename _K, typename _H = _Hash, typename = typename std::enable_if<_Is_Transparent<_H>::value>::type>
+	SSTD_INLINE iterator find(const _K& key) const {
+		return iterator(this, m_map._Search_Index(key));
+	}
+
+	SSTD_INLINE bool contains(const _KeyT& key) const {
+		return m_map.contains(key);
+	}
+	template<typename _K, typename _H = _Hash, typename = typename std::enable_if<_Is_Transparent<_H>::value>::type>
+	SSTD_INLINE bool contains(const _K& key) const {
+		return m_map.contains(key);
+	}
+
+	// Add every key of other ( other is left as it is )
+	SSTD_INLINE void merge(const unordered_set& other) {
+		if (this == &other) {
+			return;
+		}
+		// Grow once up front, instead of doubling over and over in the middle
+		m_map._Finish_Migration();
+		const sizet need = static_cast<sizet>((m_map.m_size + other.size()) / m_map.m_max_load_factor) + 1;
+		if (need > m_map.m_table.capacity) {
+			m_map.reserve(need - m_map.m_table.capacity);
+		}
+		_For_Each_Group(other.m_map, [&](const _Table& tab, const sizet& base, const uint64& mask) {
+			_Prefetch_Group(other.m_map, tab, base, mask, m_map);
+			for (uint64 m = mask; m; m &= m - 1) {
+				const _Slot_T& slot = tab.slots[base + (_Count_Trailing_Zeros(m) >> _Group::shift)];
+				m_map._Find_Or_Prepare_Insert(slot.key, _Hash_In(m_map, other.m_map, slot));
+			}
+		});
+	}
+
+	// Keep only the keys that are in other too
+	SSTD_INLINE void intersect_with(const unordered_set& other) {
+		if (this == &other) {
+			return;
+		}
+		m_map._Finish_Migration();
+		_Table& tab = m_map.m_table;
+		for (sizet base = 0; base < tab.capacity; base += _Group::width) {
+			uint64 mask = _Group(tab.ctrl + base).match_full();
+			_Prefetch_Group(m_map, tab, base, mask, other.m_map);
+			while (mask) {
+				const sizet ind = base + (_Count_Trailing_Zeros(mask) >> _Group::shift);
+				const _Slot_T& slot = tab.slots[ind];
+				if (other.m_map._Search_Index(slot.key, _Hash_In(other.m_map, m_map, slot)) != other.m_map._End_Index()) {
+					mask &= mask - 1;
+					continue;
+				}
+				m_map._Erase_At(tab, ind);
+				if constexpr (map_type::s_robin_hood) {
+					// The backward shift may have pulled the next key of the run into ind, look at it again
+					mask = _Group(tab.ctrl + base).match_full() & (~uint64(0) << ((ind - base) << _Group::shift));
+				}
+				else {
+					mask &= mask - 1;
+				}
+			}
+		}
+	}
+
+	// Is every key of other in this set
+	SSTD_INLINE bool contains_all(const unordered_set& other) const {
+		if (other.size() > size()) {
+			return false;
+		}
+		bool res = true;
+		_For_Each_Group(other.m_map, [&](const _Table& tab, const sizet& base, const uint64& mask) {
+			if (!res) {
+				return;
+			}
+			_Prefetch_Group(other.m_map, tab, base, mask, m_map);
+			for (uint64 m = mask; m; m &= m - 1) {
+				const _Slot_T& slot = tab.slots[base + (_Count_Trailing_Zeros(m) >> _Group::shift)];
+				if (m_map._Search_Index(slot.key, _Hash_In(m_map, other.m_map, slot)) == m_map._End_Index()) {
+					res = false;
+					return;
+				}
+			}
+		});
+		return res;
+	}
+
+	SSTD_INLINE void reserve(const sizet& _size) {
+		m_map.reserve(_size);
+	}
+
+	// Same as unordered_map::set_rehash_step
+	SSTD_INLINE void set_rehash_step(const sizet& step) noexcept {
+		m_map.set_rehash_step(step);
+	}
+
+	SSTD_INLINE SSTD_CONSTEXPR sizet size() const noexcept {
+		return m_map.size();
+	}
+	SSTD_INLINE SSTD_CONSTEXPR sizet capacity() const noexcept {
+		return m_map.capacity();
+	}
+	SSTD_INLINE SSTD_CONSTEXPR bool empty() const noexcept {
+		return m_map.empty();
+	}
+	SSTD_INLINE SSTD_CONSTEXPR Decimal load_factor() const {
+		return m_map.load_factor();
+	}
+
+	SSTD_INLINE iterator begin() const noexcept {
+		return iterator(this, m_map._Next_Full(0));
+	}
+	SSTD_INLINE iterator end() const noexcept {
+		return iterator(this, m_map._End_Index());
+	}
+	SSTD_INLINE iterator cbegin() const noexcept {
+		return begin();
+	}
+	SSTD_INLINE iterator cend() const noexcept {
+		return end();
+	}
+private:
+	map_type m_map;
+
+	// For the iterator, which only sees the set
+	SSTD_INLINE sizet _Next_Full(const sizet& ind) const noexcept {
+		return m_map._Next_Full(ind);
+	}
+	SSTD_INLINE const _KeyT& _Key_At(const sizet& ind) const noexcept {
+		return m_map._Key_At(ind);
+	}
+
+	template<typename _K>
+	SSTD_INLINE std::pair<iterator, bool> _Insert(_K&& key) {
+		const std::pair<sizet, bool> res = m_map._Find_Or_Prepare_Insert(std::forward<_K>(key));
+		return { iterator(this, res.first), !res.second };
+	}
+
+	// Hash of a key of source, for a lookup in target
+	// A cached hash is reused if both hashers have the same seed
+	static SSTD_INLINE sizet _Hash_In(const map_type& target, const map_type& source, const _Slot_T& slot) {
+		if constexpr (map_type::s_cache_hash) {
+			if (_Hash_Seed<_Hash>::get(target.m_Hasher) == _Hash_Seed<_Hash>::get(source.m_Hasher)) {
+				return slot.hash;
+			}
+		}
+		return target.m_Hasher(slot.key);
+	}
+
+	// Call func(table, first slot of the group, full slots of the group) for every group of map that has a key,
+	// in both tables while map is rehashing
+	template<typename _Func>
+	static SSTD_INLINE void _For_Each_Group(const map_type& map, _Func&& func) {
+		const _Table* tables[2] = { &map.m_table, &map.m_old_table };
+		for (const _Table* tab : tables) {
+			for (sizet base = 0; base < tab->capacity; base += _Group::width) {
+				const uint64 mask = _Group(tab->ctrl + base).match_full();
+				if (mask) {
+					func(*tab, base, mask);
+				}
+			}
+		}
+	}
+
+	// Prefetch where the keys of the full slots in mask would be in target
+	static SSTD_INLINE void _Prefetch_Group(const map_type& source, const _Table& tab, const sizet& base, uint64 mask, const map_type& target) {
+		for (; mask; mask &= mask - 1) {
+			const _Slot_T& slot = tab.slots[base + (_Count_Trailing_Zeros(mask) >> _Group::shift)];
+			target._Prefetch_Home(target.m_table, _Hash_In(target, source, slot));
+		}
+	}
+};
+
+// -----------------------------------------
+//
+//   Forward Iterator
+//
+// -----------------------------------------
+
+template<
+	typename _KeyT,
+	typename _Hash,
+	typename _ProbT
+>
+class _Unordered_Set_Iterator : public const_forward_iterator<_KeyT> {
+	using _Set = unordered_set<_KeyT, _Hash, _ProbT>;
+public:
+	_Unordered_Set_Iterator(const _Set* _set, sizet ind) :
+		m_set(_set), m_ind(ind) {
+
+	}
+
+	SSTD_INLINE _Unordered_Set_Iterator& operator++() noexcept {
+		m_ind = m_set->_Next_Full(m_ind + 1);
+		return *this;
+	}
+	SSTD_INLINE _Unordered_Set_Iterator operator++(int) noexcept {
+		_Unordered_Set_Iterator tmp = *this;
+		m_ind = m_set->_Next_Full(m_ind + 1);
+		return tmp;
+	}
+
+	SSTD_INLINE const _KeyT& operator*() const noexcept {
+		return m_set->_Key_At(m_ind);
+	}
+	SSTD_INLINE const _KeyT* operator->() const noexcept {
+		return &m_set->_Key_At(m_ind);
+	}
+
+	SSTD_INLINE bool operator==(const _Unordered_Set_Iterator& other) const noexcept {
+		return m_set == other.m_set && m_ind == other.m_ind;
+	}
+
+	SSTD_INLINE bool operator!=(const _Unordered_Set_Iterator& other) const noexcept {
+		return m_set != other.m_set || m_ind != other.m_ind;
+	}
+private:
+	const _Set* m_set;
+	sizet m_ind;
+};
+
+SSTD_END
+
+#endif
@@ -3,13 +3,14 @@
 
 #include "core.hpp"
 #include "Iterator.hpp"
-#include "Debug/Debug.hpp"
 
 #include <initializer_list>
 #include <utility>
 #include <stdlib.h>
 #include <malloc.h>
 #include <algorithm>
+#include <cstring>
+#include <type_traits>
 #include <xmemory>
 #include <new>
 #include <utility>
@@ -25,9 +26,47 @@ class _Vector_Const_Iterator;
 template<typename T>
 class _Vector_Const_Reverse_Iterator;
 
+// Move count objects from src to the uninitialized dst, and destroy them in src
+// Goes back to front, so it's fine if dst overlaps the end of src ( shifting to the right )
+template<typename T>
+SSTD_INLINE void _Relocate(T* dst, T* src, const sizet& count) {
+	// Nothing to move, and moving an object onto itself would destroy it
+	if (dst == src || count == 0) {
+		return;
+	}
+	if constexpr (is_trivially_relocatable<T>::value) {
+		std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), sizeof(T) * count);
+	}
+	else {
+		for (sizet i = count; i-- > 0;) {
+			new (dst + i) T(std::move(src[i]));
+			src[i].~T();
+		}
+	}
+}
+
+// Same as _Relocate, but front to back, for shifting to the left
+template<typename T>
+SSTD_INLINE void _Relocate_Left(T* dst, T* src, const sizet& count) {
+	if (dst == src || count == 0) {
+		return;
+	}
+	if constexpr (is_trivially_relocatable<T>::value) {
+		std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), sizeof(T) * count);
+	}
+	else {
+		for (sizet i = 0; i < count; ++i) {
+			new (dst + i) T(std::move(src[i]));
+			src[i].~T();
+		}
+	}
+}
+
 // This vector clone made a little change in the way it allocates memory
 // The std::vector uses new / delete aka the c++ allocator way to allocate memory
 // This sstd::vector uses malloc / realloc to get that sweet performance buff
+// ( realloc / memmove only move the bytes, so that's only for sstd::is_trivially_relocatable types,
+//   everything else gets moved one by one into the new memory )
 // 
 // This sstd::vector has about three times the speed of std::vector without reserve
 // And about two times the speed with reserve
@@ -63,6 +102,45 @@ public:
 		_Fill_Range_Iter(0, list.begin(), list.end());
 	}
 
+	// Copy constructor, a single memcpy if T is trivially copyable
+	vector(const vector& other) :
+		m_data(other.m_size ? (T*)malloc(sizeof(T) * other.m_size) : nullptr), m_capacity(other.m_size) {
+		_Copy_From(other);
+	}
+
+	// Move constructor, just takes the buffer
+	vector(vector&& other) noexcept :
+		m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)), m_capacity(std::exchange(other.m_capacity, 0)) {
+
+	}
+
+	// Reuses the buffer if it's big enough
+	vector& operator=(const vector& other) {
+		if (this == &other) {
+			return *this;
+		}
+		for (sizet i = 0; i < m_size; ++i) {
+			m_data[i].~T();
+		}
+		m_size = 0;
+		if (m_capacity < other.m_size) {
+			free(m_data);
+			_Malloc_Data(other.m_size);
+		}
+		_Copy_From(other);
+		return *this;
+	}
+
+	vector& operator=(vector&& other) noexcept {
+		if (this != &other) {
+			clear();
+			m_data = std::exchange(other.m_data, nullptr);
+			m_size = std::exchange(other.m_size, 0);
+			m_capacity = std::exchange(other.m_capacity, 0);
+		}
+		return *this;
+	}
+
 	// Destructor
 	~vector() {
 		if (m_data) {
@@ -283,20 +361,44 @@ private:
 	// it extends the current allocated memory, 
 	// ( Allocate another chunk of memory if extension is not possible.
 	SSTD_INLINE void _Realloc_Data(sizet memsize) {
-		T* tmp = (T*)realloc(m_data, sizeof(T) * memsize);
-
-		// Handle situations if there aren't enough memory to extend
-		if (tmp == nullptr) {
+		T* tmp = nullptr;
+		if constexpr (is_trivially_relocatable<T>::value) {
+			tmp = (T*)realloc(static_cast<void*>(m_data), sizeof(T) * memsize);
+			// Handle situations if there aren't enough memory to extend
+			if (tmp == nullptr) {
+				tmp = (T*)malloc(sizeof(T) * memsize);
+				if (m_size) {
+					std::memcpy(static_cast<void*>(tmp), static_cast<const void*>(m_data), sizeof(T) * m_size);
+				}
+				// Has already copyed the old data to the new memory, so the old memory is useless
+				free(m_data);
+			}
+		}
+		else {
+			// The objects need to know they moved, so no realloc
 			tmp = (T*)malloc(sizeof(T) * memsize);
-			std::copy(m_data, m_data + m_capacity, tmp);
-
-			// Has already copyed the old data to the new memory, so the old memory is useless
+			_Relocate<T>(tmp, m_data, m_size);
 			free(m_data);
 		}
 		m_data = tmp;
 		m_capacity = memsize;
 	}
 
+	// Copy every object of other into the empty buffer, which has room for them
+	SSTD_INLINE void _Copy_From(const vector& other) {
+		if constexpr (std::is_trivially_copyable<T>::value) {
+			if (other.m_size) {
+				std::memcpy(m_data, other.m_data, sizeof(T) * other.m_size);
+			}
+		}
+		else {
+			for (sizet i = 0; i < other.m_size; ++i) {
+				new (m_data + i) T(other.m_data[i]);
+			}
+		}
+		m_size = other.m_size;
+	}
+
 	SSTD_INLINE void _Fill_Range(sizet start, sizet end) {
 		for (; start < end; ++start) {
 			new (&m_data[start]) T();
@@ -305,14 +407,14 @@ private:
 
 	SSTD_INLINE void _Fill_Range(sizet start, sizet end, const T& val) {
 		for (; start < end; ++start) {
-			m_data[start] = val;
+			new (&m_data[start]) T(val);
 		}
 	}
 
 	template<typename _Iter>
 	SSTD_INLINE void _Fill_Range_Iter(sizet pos, _Iter _Start, _Iter _End) {
 		for (; _Start != _End; ++pos, ++_Start) {
-			m_data[pos] = *_Start;
+			new (&m_data[pos]) T(*_Start);
 		}
 	}
 
@@ -323,27 +425,22 @@ private:
 	SSTD_INLINE void _Insert_At(sizet pos, _Iter iter_beg, _Iter iter_end) {
 		const sizet Dis = iter_end - iter_beg;
 		const sizet Total_Cap = m_size + Dis;
-		if (Total_Cap > m_capacity) {
-			// Allocate more space
-			_Realloc_Data(Total_Cap);
-		}
 		if (pos > m_size) {
 			// completly out side the 'insertable range'
 			throw std::out_of_range("Invalid insert position");
 			return;
 		}
-		if (pos < m_size) {
-			if (false && std::is_trivially_move_constructible<T>::value) {
-				std::memmove(m_data + pos + Dis, m_data + pos, sizeof(T) * (m_size - pos));
-			}
-			else {
-				for (int i = pos; i < m_size; ++i) {
-					new (m_data + Dis + i) T(std::move(m_data[i]));
-				}
-			}
+		if (Dis == 0) {
+			return;
 		}
-		m_size += Dis;
+		if (Total_Cap > m_capacity) {
+			// Allocate more space
+			_Realloc_Data(Total_Cap);
+		}
+		// Make a gap of Dis objects at pos
+		_Relocate<T>(m_data + pos + Dis, m_data + pos, m_size - pos);
 		_Fill_Range_Iter(pos, iter_beg, iter_end);
+		m_size += Dis;
 	}
 
 	SSTD_INLINE void _Erase(const sizet& ind) {
@@ -351,35 +448,23 @@ private:
 		if (std::is_destructible<T>::value) {
 			m_data[ind].~T();
 		}
-		// Just override it
-		if (std::is_trivially_move_constructible<T>::value) {
-			std::memmove(m_data + ind, m_data + ind + 1, sizeof(T) * (m_size - ind - 1));
-		}
-		else {
-			for (int i = ind; i < m_capacity; ++i) {
-				new (m_data + i) T(std::move(m_data[i + 1]));
-			}
-		}
+		// Close the gap
+		_Relocate_Left<T>(m_data + ind, m_data + ind + 1, m_size - ind - 1);
 		--m_size;
 	}
 
 	SSTD_INLINE void _Erase_Range(const sizet& _start, const sizet& _end) {
+		if (_start == _end) {
+			return;
+		}
 		// Destruct if possible
 		for (sizet i = _start; i < _end; ++i) {
 			if (std::is_destructible<T>::value) {
 				m_data[i].~T();
 			}
 		}
-		// Just override it
-		if (std::is_trivially_move_constructible<T>::value) {
-			std::memmove(m_data + _start, m_data + _end, sizeof(T) * (m_size - _end));
-		}
-		else {
-			const sizet Dis = _start - _end;
-			for (int i = _start; i < _end; ++i) {
-				new (m_data + i) T(std::move(m_data[i + Dis]));
-			}
-		}
+		// Close the gap
+		_Relocate_Left<T>(m_data + _start, m_data + _end, m_size - _end);
 		m_size-=_end - _start;
 	}
 